@@ -0,0 +1,47 @@
+/*
+ *  minikernel/kernel/include/anillo.h
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Fernando Pérez Costoya
+ *
+ */
+
+/*
+ *
+ * Fichero de cabecera que contiene el anillo de llamadas al sistema que
+ * comparten un proceso y el nucleo: el proceso encola peticiones y las
+ * envia todas con una unica llamada (enviar_anillo); el nucleo deja el
+ * resultado de cada una en la cola de respuestas.
+ *
+ */
+
+#ifndef _ANILLO_H
+#define _ANILLO_H
+
+#define TAM_ANILLO 16		/* entradas de cada cola (potencia de 2) */
+#define MAX_ARGS_ANILLO 3	/* argumentos de una peticion */
+
+typedef struct peticion_llamsis_t {
+	int llamada;			/* numero de llamada (llamsis.h) */
+	long args[MAX_ARGS_ANILLO];	/* registros 1, 2, ... */
+	long dato;			/* se devuelve tal cual en la respuesta */
+} peticion_llamsis;
+
+typedef struct respuesta_llamsis_t {
+	long dato;			/* el de la peticion */
+	int resultado;			/* lo que devuelve la llamada */
+} respuesta_llamsis;
+
+/*
+ * Los indices avanzan sin limite y se toman modulo TAM_ANILLO: el proceso
+ * solo escribe fin_pet y ini_resp, y el nucleo solo ini_pet y fin_resp.
+ */
+typedef struct anillo_llamsis_t {
+	volatile unsigned int ini_pet, fin_pet;
+	peticion_llamsis pet[TAM_ANILLO];
+	volatile unsigned int ini_resp, fin_resp;
+	respuesta_llamsis resp[TAM_ANILLO];
+} anillo_llamsis;
+
+#endif /* _ANILLO_H */
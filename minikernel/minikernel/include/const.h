@@ -22,9 +22,33 @@
 #define NULL (void *) 0		/* por si acaso no esta ya definida */
 #endif
 
-#define MAX_PROC 10		/* dimension de tabla de procesos */
+#define MAX_PROC 10		/* dimension inicial de tabla de procesos */
 
-#define TAM_PILA 32768
+/*
+ * El id de un proceso codifica su entrada en la tabla (bits bajos) y la
+ * generacion de esa entrada, que avanza cada vez que se libera. Se deja
+ * libre el bit alto para que id+1 quepa en la palabra de cerrojo junto a
+ * FUTEX_ESPERANDO
+ */
+#define BITS_ENTRADA_PROC 16
+#define MAX_ENTRADAS_PROC (1<<BITS_ENTRADA_PROC)
+#define MASCARA_ID_PROC 0x3FFFFFFF
+
+#define TAM_PILA 32768		/* tamaño de pila por defecto */
+
+/*
+ * Cache de pilas: una por cada clase de tamaño, potencias de 2 desde
+ * TAM_PILA_MIN hasta TAM_PILA_MIN<<(NUM_CLASES_PILA-1). Las interrupciones
+ * y la terminacion del proceso (con el informe final) usan su pila, por lo
+ * que ninguna puede ser menor que TAM_PILA_MIN
+ */
+#define TAM_PILA_MIN 16384
+#define NUM_CLASES_PILA 8
+#define MAX_PILAS_CACHE 16	/* pilas libres que guarda cada clase */
+#define PILAS_INICIALES 4	/* pilas de TAM_PILA reservadas al arrancar */
+
+/* entradas de la tabla hash de la cache de imagenes (potencia de 2) */
+#define TAM_TABLA_IMAGENES 32
 
 /*
  * Posibles estados del proceso
@@ -34,14 +58,25 @@
 #define LISTO 1
 #define EJECUCION 2
 #define BLOQUEADO 3
+#define ESTRANGULADO 4	/* proc. de tiempo real esperando su siguiente periodo */
 
 /* defines para el mutex  */
 #define NO_RECURSIVO 0
 #define RECURSIVO 1
 #define OCUPADO 0
 #define LIBRE 1
-#define MUT_DESBLOQUEADO 0
-#define MUT_BLOQUEADO 1
+#define ERR_INTERBLOQUEO -2	/* el lock cerraria un ciclo de espera */
+#define LOCKSTAT_TOP 0		/* objetos del informe final de contienda (0: ninguno) */
+
+/* defines para los cerrojos de lectores/escritores */
+#define RW_PREF_LECTORES 0	/* entran lectores mientras no haya escritor */
+#define RW_PREF_ESCRITORES 1	/* un escritor esperando detiene a los lectores nuevos */
+
+/* primitiva a la que corresponde un objeto de la tabla de mutex */
+#define PRIM_MUTEX 0
+#define PRIM_RW 1
+#define PRIM_SEM 2	/* semaforo contador */
+#define PRIM_COND 3	/* variable condicion */
 
 
 
@@ -74,17 +109,72 @@
 /* frecuencia de reloj requerida (ticks/segundo) */
 #define TICK 100
 
+/* constantes usadas en la planificacion por prioridades */
+#define NUM_PRIORIDADES 32	/* niveles de la cola de listos (0 la maxima) */
+#define PRIORIDAD_DEFECTO 16	/* prioridad del proceso inicial */
+
+/* clases de planificacion: CLASE_TR ejecuta antes que CLASE_PRIORIDAD y
+   esta antes que CLASE_JUSTA */
+#define CLASE_PRIORIDAD 0	/* prioridades fijas con round-robin */
+#define CLASE_JUSTA 1		/* reparto por tiempo virtual de ejecucion */
+#define CLASE_TR 2		/* tiempo real periodico, plazo mas cercano primero */
+
+/* utilizacion maxima (en milesimas) admitida para la clase de tiempo real */
+#define UTILIZACION_MAX_TR 900
+
+/* constantes usadas en la clase justa (en ticks) */
+#define GRANULARIDAD_JUSTA 2	/* ventaja minima para expulsar */
+#define CREDITO_DORMIDO 5	/* ventaja maxima al despertar */
+
 /* constante usada en implementacion de round robin */
 #define TICKS_POR_RODAJA 10
 
+/* constantes usadas en la rueda jerarquica de temporizadores */
+#define RUEDA_NIVELES 4	/* numero de niveles de la rueda */
+#define RUEDA_BITS 6	/* log2 del numero de ranuras de cada nivel */
+#define RUEDA_RANURAS (1 << RUEDA_BITS)
+#define RUEDA_MASCARA (RUEDA_RANURAS - 1)
+
+/* modo de reloj dinamico: con la UCP ociosa se omiten los ticks hasta el
+   siguiente vencimiento (1 activado, 0 desactivado) */
+#define RELOJ_DINAMICO 1
+
+/* variable de entorno con los parametros de arranque ("nombre=valor ...") */
+#define VAR_ARRANQUE "MINIKERNEL_ARGS"
+
 /* constantes usada en implementacion de mutex */
-#define NUM_MUT 16 /* numero total de mutex en el sistema */
+#define NUM_MUT 16 /* numero total de mutex en el sistema (por defecto) */
 #define NUM_MUT_PROC 4 /* numero maximo de mutex que puede tener
-			  abiertos un proceso */
+			  abiertos un proceso (por defecto) */
+#define MUT_POR_BLOQUE 32 /* mutex que se reservan juntos al ampliar el slab */
 #define MAX_NOM_MUT 8 /* longitud maxima de un nombre de mutex */
-
-/* constante usada en implementacion de manejador de terminal */
-#define TAM_BUF_TERM 8 /* tamaño del buffer del terminal */
+#define TAM_HASH_MUT 32 /* entradas de la tabla hash de nombres (potencia de 2) */
+
+/* constantes usadas en implementacion de manejador de terminal */
+#define TAM_BUF_TERM 64 /* tamaño del buffer del terminal (potencia de 2);
+			   limita la longitud de una linea en modo canonico */
+#define TERM_CRUDO 0	/* cada caracter se puede leer en cuanto llega */
+#define TERM_CANONICO 1	/* solo se leen lineas completas, ya editadas */
+#define CAR_FIN_FICHERO 4	/* control-D: fin de fichero en modo canonico */
+#define CAR_BORRAR 8		/* retroceso: borra el ultimo caracter */
+#define CAR_SUPRIMIR 127	/* tambien borra el ultimo caracter */
+
+/* constantes usadas en el registro (log) del nucleo */
+#define TAM_LOG 256		/* registros que guarda el anillo */
+#define MAX_ARGS_LOG 6		/* argumentos de un mensaje */
+#define TAM_CADENAS_LOG 24	/* copia de los argumentos %s de un mensaje */
+#define TAM_LINEA_LOG 160	/* longitud maxima de un mensaje formateado */
+#define LOG_ERROR 0
+#define LOG_AVISO 1
+#define LOG_INFO 2
+#define LOG_DEPURACION 3	/* por tick, cambio de contexto y operacion */
+#define NIVEL_LOG LOG_INFO	/* umbral por defecto (parametro nivel_log) */
+
+/* constantes usadas en la consola con escritura combinada */
+#define TAM_BUF_CONSOLA 1024	/* lineas completas pendientes de escribir */
+#define TAM_LINEA_CONSOLA 128	/* linea en curso de cada proceso */
+#define CONSOLA_LINEAS 0	/* la salida se agrupa por lineas (por defecto) */
+#define CONSOLA_DIRECTA 1	/* cada escritura va directamente a la consola */
 
 /* dirección de puerto de E/S del terminal */
 #define DIR_TERMINAL 1
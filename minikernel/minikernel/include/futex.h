@@ -0,0 +1,67 @@
+/*
+ *  minikernel/kernel/include/futex.h
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Fernando Pérez Costoya
+ *
+ */
+
+/*
+ *
+ * Fichero de cabecera que contiene los tipos compartidos entre el nucleo
+ * y la biblioteca de servicios para el camino rapido de los mutex: la
+ * palabra de cerrojo de cada mutex y la zona donde el nucleo publica los
+ * datos del proceso en ejecucion.
+ *
+ */
+
+#ifndef _FUTEX_H
+#define _FUTEX_H
+
+/*
+ * Palabra de cerrojo: 0 si esta libre o el identificador del poseedor mas
+ * uno, con el bit FUTEX_ESPERANDO activo si hay procesos bloqueados en el
+ * nucleo. Biblioteca y nucleo la modifican con operaciones atomicas; solo
+ * se entra al nucleo si hay contienda.
+ */
+#define FUTEX_ESPERANDO 0x80000000U
+
+/*
+ * Estadisticas de contienda de los objetos con un mismo nombre. Las
+ * actualiza quien obtiene o suelta el objeto, sea el nucleo o libserv.
+ */
+typedef struct estad_futex_t {
+	unsigned long adquisiciones;	/* veces que se ha obtenido */
+	unsigned long contendidas;	/* de ellas, tras esperar */
+	unsigned long espera_total;	/* ticks esperando */
+	unsigned long espera_max;
+	unsigned long posesion_total;	/* ticks poseido (mutex y escritores) */
+	int profundidad_max;		/* pico de bloqueos recursivos */
+} estad_futex;
+
+typedef struct palabra_futex_t {
+	volatile unsigned int palabra;	/* poseedor+1 | FUTEX_ESPERANDO */
+	int tipo;			/* RECURSIVO | NO_RECURSIVO */
+	int profundidad;		/* veces bloqueado por el poseedor */
+	unsigned long inicio;		/* tick en que lo obtuvo el poseedor */
+	estad_futex *estad;		/* nunca nulo */
+} palabra_futex;
+
+/*
+ * Zona que el nucleo actualiza en cada cambio de proceso: identificador
+ * del proceso en ejecucion y su tabla de descriptores de mutex (cada
+ * entrada apunta a la palabra de cerrojo del mutex o es NULL). Incluye
+ * el reloj del sistema para medir tiempos de posesion.
+ */
+typedef struct zona_futex_t {
+	int id;
+	palabra_futex **descriptores;
+	int tam_descriptores;
+	volatile unsigned long *ticks;
+} zona_futex;
+
+/* valor de la palabra de cerrojo cuando la posee el proceso id */
+#define FUTEX_POSEEDOR(id) ((unsigned int)(id) + 1)
+
+#endif /* _FUTEX_H */
@@ -22,8 +22,47 @@
 #include "const.h"
 #include "HAL.h"
 #include "llamsis.h"
+#include "futex.h"
+#include "anillo.h"
+#include "pagina.h"
 #include "time.h"
 
+/*
+*
+* Definicion del tipo que corresponde con un temporizador de la rueda.
+* Se encadena en la ranura que le corresponde segun su tick absoluto de
+* expiracion y, al vencer, se invoca funcion(arg) con las interrupciones
+* de reloj inhibidas.
+*
+*/
+typedef struct TEMP_t *TEMPptr;
+
+typedef struct TEMP_t {
+	unsigned long expiracion;	/* tick absoluto de vencimiento */
+	void (*funcion)(void *);	/* rutina a invocar al vencer */
+	void *arg;			/* argumento de la rutina */
+	TEMPptr siguiente;		/* enlaces dentro de la ranura */
+	TEMPptr anterior;
+	TEMPptr *ranura;		/* ranura en la que esta (NULL si inactivo) */
+} temporizador;
+
+/*
+*
+* Definicion del tipo que corresponde con una imagen de programa cargada.
+* La comparten todos los procesos vivos que ejecutan ese programa y se
+* libera cuando termina el ultimo.
+*
+*/
+typedef struct IMAGEN_t *IMAGENptr;
+
+typedef struct IMAGEN_t {
+	char *nombre;			/* programa del que se ha cargado */
+	void *info_mem;			/* descriptor del mapa de memoria */
+	void *pc_inicial;		/* punto de arranque del programa */
+	int referencias;		/* procesos que la usan */
+	IMAGENptr siguiente;		/* siguiente en la misma entrada hash */
+} imagen_prog;
+
 /*
 *
 * Definicion del tipo que corresponde con el BCP.
@@ -37,16 +76,52 @@ typedef struct BCP_t {
 	int estado;			/* TERMINADO|LISTO|EJECUCION|BLOQUEADO*/
 	contexto_t contexto_regs;	/* copia de regs. de UCP */
 	void * pila;			/* dir. inicial de la pila */
+	int tam_pila;			/* tamaño de la pila */
 	BCPptr siguiente;		/* puntero a otro BCP */
+	BCPptr anterior;		/* BCP previo en su lista */
+	struct lista_BCPs_t *lista;	/* lista en la que esta (NULL si ninguna) */
 	void *info_mem;			/* descriptor del mapa de memoria */
+	IMAGENptr imagen;		/* imagen compartida de su programa */
+	int prioridad;			/* nivel en la cola de listos (efectiva) */
+	int prioridad_base;		/* fijada por el proceso, sin herencia */
+	int elevado;			/* prioridad heredada de un mutex */
+	unsigned long inicio_elevacion;	/* tick en que se elevo */
+	int rodaja;			/* ticks que le quedan de rodaja */
+	int clase;			/* CLASE_PRIORIDAD|CLASE_JUSTA */
+	unsigned long vruntime;		/* tiempo virtual ejecutado (ticks) */
+	int pos_monticulo;		/* posicion en su monticulo (-1 si no esta) */
+
+	/* CLASE_TR: parametros declarados (ticks) y estado del trabajo actual */
+	unsigned long periodo;
+	unsigned long presupuesto;
+	unsigned long plazo;
+	int densidad;			/* presupuesto/plazo en milesimas */
+	unsigned long plazo_abs;	/* tick absoluto del plazo actual */
+	unsigned long presupuesto_rest;	/* ticks restantes en este periodo */
+	int estrangulado;		/* presupuesto agotado en este periodo */
+	temporizador temp_periodo;	/* inicio del siguiente periodo */
 	
 	//supuestamente es recomendable añadir un campo "Modificar el BCP para incluir algún campo relacionado con esta llamada"
-	unsigned int tiempo_dormir; // no es en SEGUNDOS, es en TICKS
+	temporizador temp_dormir;	/* plazo de la llamada dormir */
 
 
 	/*MUTEX*/
-	int conj_descriptores[NUM_MUT_PROC];
+	struct MUT_t **conj_descriptores;	/* NULL si libre; crece bajo demanda */
+	int tam_descriptores;
 	int n_descriptores_usados;
+	struct MUT_t *mutex_esperado;	/* mutex en cuyo lock esta bloqueado */
+	char *lectura_desc;		/* descriptores de rwlock con cerrojo de lectura */
+	struct MUT_t *mutex_cond;	/* mutex a recuperar al salir de wait_cond */
+	int profundidad_cond;		/* profundidad que tenia en ese mutex */
+	unsigned long inicio_espera;	/* tick en que se bloqueo en un objeto */
+
+	/*TERMINAL*/
+	int car_terminal;		/* caracter entregado al despertarlo o -1 */
+
+	/*CONSOLA*/
+	char linea_cons[TAM_LINEA_CONSOLA];	/* linea que esta escribiendo */
+	int lon_linea_cons;
+	int consola_directa;		/* no agrupa su salida */
 	
 
 } BCP;
@@ -55,39 +130,116 @@ typedef struct BCP_t {
 *
 * Definicion del tipo que corresponde con la cabecera de una lista
 * de BCPs. Este tipo se puede usar para diversas listas (procesos listos,
-* procesos bloqueados en semaforo, etc.).
+* procesos bloqueados en semaforo, etc.). Es doblemente enlazada a traves
+* de los propios BCPs, que solo pueden estar en una lista a la vez.
 *
 */
 
-typedef struct{
+typedef struct lista_BCPs_t {
 	BCP *primero;
 	BCP *ultimo;
 } lista_BCPs;
 
+/*
+*
+* Definicion del tipo de la cola de procesos listos: una lista de BCPs por
+* nivel de prioridad y un mapa de bits con los niveles no vacios, que
+* permite encontrar el mas prioritario en tiempo constante.
+*
+*/
+typedef struct{
+	lista_BCPs nivel[NUM_PRIORIDADES];
+	unsigned int mapa;		/* bit i activo si nivel[i] no vacio */
+} cola_prioridades;
+
+/*
+*
+* Definicion del tipo de un monticulo de BCPs ordenado por la funcion menor.
+* Se amplia bajo demanda.
+*
+*/
+typedef struct{
+	BCP **elem;
+	int num;
+	int capacidad;
+	int (*menor)(BCP *, BCP *);
+} monticulo_BCPs;
+
+/*
+*
+* Definicion del tipo de la cache de pilas libres de una clase de tamaño.
+* Las pilas libres se encadenan guardando el enlace en su primera palabra.
+*
+*/
+typedef struct{
+	void *libres;
+	int num;
+	unsigned long aciertos;		/* reservas servidas desde la cache */
+	unsigned long fallos;		/* reservas que piden una pila nueva */
+} cache_pilas;
+
 /*
 *mutex*/
 typedef struct MUT_t *MUTptr;
 
 typedef struct MUT_t{
 
+	palabra_futex futex;	// cerrojo compartido con libserv: poseedor, tipo y profundidad (primer campo)
+
 	char nombre[MAX_NOM_MUT];      //nombre que no excede la constante
 	int estado;                   /* LIBRE | OCUPADO */
-	int tipo;					 //Especificación del tipo RECURSIVO | NO RECURSIVO 
-	int id_mut;
+	int primitiva;			/* PRIM_MUTEX | PRIM_RW | PRIM_SEM | PRIM_COND */
+	int num_abiertos;		// descriptores abiertos en todos los procesos
 
 	lista_BCPs lista_mut_espera;  // lista de procesos que esperan al mutex
 	int n_mut_espera;            // numero de procesos de mutex en espera: tamaño de la lista
-	int id_poseedor_mut;		// identificador del proceso que posee al mutex
-	int num_mut_bloqueos;	   // numero de mutex bloqueados
-	int estado_bloqueo_mut;	  // 0 MUT_DESBLOQUEADO | 1 MUT_BLOQUEADO
 
+	//solo PRIM_RW: el escritor es el poseedor de la palabra de cerrojo, que
+	//lleva siempre FUTEX_ESPERANDO para que libserv no la tome; en lista_mut_espera
+	//esperan los escritores
+	int preferencia;		// RW_PREF_LECTORES | RW_PREF_ESCRITORES
+	int num_lectores;		// procesos con el cerrojo de lectura
+	lista_BCPs lista_lect_espera;	// lectores bloqueados
+	int n_lect_espera;
 
+	//PRIM_SEM y PRIM_COND no tienen poseedor (la palabra lleva solo
+	//FUTEX_ESPERANDO) y sus procesos bloqueados esperan en lista_mut_espera
+	int valor;			// contador del semaforo
+
+	MUTptr siguiente;		// siguiente en su entrada hash o en la lista de libres
 
 } mutex;
 
 
 
 
+/*
+* Registro de estadisticas de contienda por nombre y primitiva. Sobrevive a
+* los objetos para que el informe final incluya los ya eliminados
+*/
+typedef struct ESTAD_MUT_t *ESTADptr;
+
+typedef struct ESTAD_MUT_t {
+	char nombre[MAX_NOM_MUT];
+	int primitiva;
+	estad_futex datos;
+	ESTADptr siguiente;		/* en su entrada hash */
+} estad_mut;
+
+/*
+* Mensaje del registro del nucleo: el formato (una cadena constante) y sus
+* argumentos sin formatear. Las cadenas se copian en el propio registro,
+* ya que pueden cambiar o liberarse antes de que se formatee
+*/
+typedef struct registro_log_t {
+	unsigned long tick;
+	int nivel;
+	const char *formato;
+	long args[MAX_ARGS_LOG];	/* las cadenas, como posicion en texto */
+	int cadenas;			/* mascara de los argumentos que son %s */
+	char texto[TAM_CADENAS_LOG];
+} registro_log;
+
 /*
 * Variable global que identifica el proceso actual
 */
@@ -97,27 +249,149 @@ BCP * p_proc_actual=NULL;
 BCP * p_proc_anterior=NULL;
 
 /*
-* Variable global que representa la tabla de procesos
+* Variable global que identifica el proceso que debe ser expulsado en la
+* proxima interrupcion software (replanificacion diferida)
 */
+BCP * p_proc_expulsar=NULL;
 
-BCP tabla_procs[MAX_PROC];
+/*
+* Variable global que representa la tabla de procesos: vector de punteros
+* a BCPs, que se duplica bajo demanda, y cola de BCPs libres encadenados
+* por su campo siguiente
+*/
+
+BCP **tabla_procs=NULL;
+int tam_tabla_procs=0;
+lista_BCPs procs_libres = {NULL, NULL};
+int num_procs_vivos=0;
+
+/*
+* Variable global que representa la cache de pilas por clase de tamaño
+*/
+cache_pilas caches_pilas[NUM_CLASES_PILA];
+
+/*
+* Variables globales de la cache de imagenes: tabla hash por nombre de
+* programa y estadisticas de uso
+*/
+IMAGENptr tabla_imagenes[TAM_TABLA_IMAGENES];
+unsigned long imagenes_aciertos=0;
+unsigned long imagenes_fallos=0;
 
 /*
 * Variable global que representa la cola de procesos listos
 */
-lista_BCPs lista_listos= {NULL, NULL};
+cola_prioridades lista_listos;
+
+/*
+* Variables globales de la clase justa: monticulo de listos ordenado por
+* tiempo virtual y minimo tiempo virtual alcanzado (no decrece)
+*/
+monticulo_BCPs cola_justos;
+unsigned long vruntime_min=0;
+
+/*
+* Variables globales de la clase de tiempo real: monticulo de listos
+* ordenado por plazo absoluto y utilizacion admitida (en milesimas)
+*/
+monticulo_BCPs cola_tr;
+int utilizacion_tr=0;
 
 
 //Enunciado: "Definir una lista de procesos esperando plazos"
 lista_BCPs lista_bloqueados = {NULL, NULL};
 
 
-//Lista de procesos esperando mutex
+/*
+* Variables globales de la rueda de temporizadores: ticks transcurridos
+* desde el arranque, siguiente tick que debe procesar la rueda y
+* ranuras de cada uno de sus niveles
+*/
+unsigned long ticks_sistema=0;
+unsigned long rueda_base=0;
+TEMPptr rueda_temp[RUEDA_NIVELES][RUEDA_RANURAS];
+
+/*
+* Variables globales del reloj dinamico: si esta permitido, si la UCP esta
+* ociosa con el reloj ralentizado, ticks que representa cada interrupcion
+* y referencia de tiempo real para recuperar los ticks omitidos
+*/
+int reloj_dinamico=RELOJ_DINAMICO;
+int reloj_ocioso=0;
+int ticks_por_int=1;
+unsigned long long ms_ref_ocioso;
+unsigned long ticks_ref_ocioso;
+
+
+//Lista de procesos esperando a que se elimine algun mutex para crear uno
 lista_BCPs lista_esperando_mut = {NULL, NULL};
 
-//lista de los mutex
-mutex lista_mut[NUM_MUT];
-int num_mut_total; //tamaño de la lista: controlamos el numero de mutex que hay 
+//cuotas de mutex: en el sistema (0 sin limite) y descriptores por proceso
+int max_mut = NUM_MUT;
+int max_desc_mut = NUM_MUT_PROC;
+int num_mut_total; //controlamos el numero de mutex que hay 
+
+//herencia de prioridad: veces que se ha elevado a un poseedor y ticks elevados
+unsigned long num_elevaciones = 0;
+unsigned long ticks_elevados = 0;
+
+//tabla hash de nombres de los mutex en uso y lista de mutex libres del slab
+MUTptr tabla_hash_mut[TAM_HASH_MUT];
+MUTptr mut_libres = NULL;
+
+//datos del proceso en ejecucion publicados a libserv para el camino rapido
+//de lock/unlock; cada imagen recibe su direccion al cargarse
+zona_futex zona_usuario;
+
+//pagina de datos del nucleo que leen las imagenes sin llamadas al sistema
+pagina_kernel pagina_nucleo;
+
+//buffer del terminal: anillo que llena int_terminal (unico productor) y
+//vacian leer_caracter y leer; cada uno escribe solo su indice, que avanza
+//sin limite y se toma modulo TAM_BUF_TERM. Con el buffer lleno se pierden
+//los caracteres que llegan
+char buf_terminal[TAM_BUF_TERM];
+volatile unsigned int ini_term = 0, fin_term = 0;
+unsigned long car_perdidos = 0;
+
+//disciplina de linea: modo del terminal y fin de la ultima linea completa
+//(entre fin_linea y fin_term esta la que se edita). Un fin de fichero con
+//la linea vacia queda pendiente en pos_eof hasta que lo recoge un lector
+int modo_terminal = TERM_CRUDO;
+volatile unsigned int fin_linea = 0;
+int hay_eof = 0;
+unsigned int pos_eof;
+
+//registro del nucleo: anillo de mensajes sin formatear cuyos indices (que
+//avanzan sin limite) son el mas antiguo que se conserva, el siguiente a
+//volcar en la consola y el siguiente libre. Los mensajes por encima del
+//umbral nivel_log no se registran; los que se descartan sin haberse
+//volcado se cuentan
+registro_log anillo_log[TAM_LOG];
+unsigned long ini_log = 0, vol_log = 0, fin_log = 0;
+int nivel_log = NIVEL_LOG;
+unsigned long log_perdidos = 0;
+
+//consola: lineas completas de los procesos y mensajes del nucleo que se
+//escriben juntos al llenarse, en cada tick y con la UCP ociosa; escrituras
+//reales y llamadas escribir que han cubierto
+char buf_consola[TAM_BUF_CONSOLA];
+int lon_buf_consola = 0;
+unsigned long escrituras_consola = 0;
+unsigned long llamadas_escribir = 0;
+
+//proceso cuya linea sin terminar es lo ultimo que se ha encolado (NULL si
+//se acabo en salto de linea): lo que escriba otro empieza en linea nueva
+BCPptr linea_cortada = NULL;
+
+//procesos bloqueados en leer_caracter, en orden de llegada
+lista_BCPs lista_lectores = {NULL, NULL};
+
+//estadisticas de contienda: registros por nombre, registro comun si no hay
+//memoria para uno nuevo y objetos a mostrar al terminar (parametro lockstat)
+ESTADptr tabla_estad_mut[TAM_HASH_MUT];
+estad_mut estad_descartadas;
+int lockstat_top;
 
 
 /*
@@ -139,6 +413,8 @@ int contar_ticks(int ticks);
 /*
 * Prototipos de las rutinas que realizan cada llamada al sistema
 */
+BCP * buscar_BCP(int id);
+
 int sis_crear_proceso();
 int sis_terminar_proceso();
 int sis_escribir();
@@ -147,15 +423,73 @@ int sis_escribir();
 
 int obtener_id_pr();
 int dormir(unsigned int segundos);
+int fijar_tiempo_real(unsigned int periodo, unsigned int presupuesto,
+	unsigned int plazo);
+int esperar_periodo();
+int fijar_prioridad(unsigned int prioridad);
+int fijar_clase(unsigned int clase);
+int enviar_anillo(anillo_llamsis *anillo);
+int leer_caracter();
+int leer(char *buf, unsigned int n);
+int fijar_modo_terminal(int modo);
+int leer_log(char *buf, unsigned int tam);
+int fijar_nivel_log(int nivel);
+int fijar_consola(int modo);
 
 /*        SERVICIOS MUTEX        */
 int crear_mutex(char *nombre, int tipo);
 void iniciar_tabla_mut();
 
-//Funciones aux para crear_mutex: búsqueda por nombre y búsqueda de un hueco en el array de descriptores
-int buscar_mutex_nombre(char* nombre);
-int buscar_hueco_mutex();
+//Funciones aux del registro del nucleo: registrar un mensaje, formatearlo
+//y volcar en la consola los pendientes
+void registrar(int nivel, const char *formato, ...);
+int formatear_registro(registro_log *reg, char *buf, int tam);
+void volcar_log();
+
+//Funciones aux de la consola: añadir texto al buffer, escribirlo, pasar
+//al buffer la linea de un proceso y agrupar lo que escribe
+void separar_linea(BCPptr proc);
+void encolar_consola(BCPptr proc, char *texto, int lon);
+void vaciar_consola();
+void vaciar_salida();
+void pasar_linea(BCPptr proc);
+void escribir_consola(BCPptr proc, char *texto, unsigned int longi);
+
+//Funciones aux del terminal: despertar al primer lector y leer del buffer
+void despertar_lector();
+int leer_terminal(char *buf, unsigned int n);
+
+//Funciones aux para mutex: búsqueda por nombre y por descriptor, búsqueda de un hueco en el array de descriptores y cierre
+int ampliar_slab_mut();
+MUTptr buscar_mut_nombre(char *nombre);
 int buscar_hueco_descriptores();
+MUTptr mutex_de_descriptor(unsigned int desc);
+int poseedor_mut(MUTptr mut);
+void publicar_zona_futex(BCPptr proc);
+void publicar_pagina(BCPptr proc);
+void soltar_mutex(MUTptr mut);
+void despertar_creador();
+void eliminar_mutex(MUTptr mut);
+void cerrar_descriptor(BCPptr proc, int desc);
+void cerrar_descriptores_mutex(BCPptr proc);
+void fijar_prioridad_efectiva(BCPptr proc, int prioridad);
+void heredar_prioridad(MUTptr mut, int prioridad);
+void recalcular_prioridad(BCPptr proc);
+int detectar_interbloqueo(MUTptr mut);
+estad_futex *buscar_estad_mut(char *nombre, int primitiva);
+void anotar_adquisicion(MUTptr mut, BCPptr proc, int contendida);
+void anotar_profundidad(MUTptr mut);
+void anotar_liberacion(MUTptr mut);
+void informe_lockstat(int n);
+int crear_objeto_mut(char *nombre, int primitiva, int tipo);
+int abrir_objeto_mut(char *nombre, int primitiva);
+MUTptr objeto_de_descriptor(unsigned int desc, int primitiva);
+void ceder_mutex(MUTptr mut);
+void conceder_rw(MUTptr rw);
+void soltar_lectura(BCPptr proc, MUTptr rw, int desc);
+void soltar_escritura(BCPptr proc, MUTptr rw);
+int tipo_valido(int primitiva, int tipo);
+void despertar_cond(MUTptr cond);
 
 
 int abrir_mutex(char *nombre);
@@ -163,6 +497,28 @@ int lock(unsigned int mutexid);
 int unlock(unsigned int mutexid);
 int cerrar_mutex(unsigned int mutexid);
 
+/*        SERVICIOS RWLOCK        */
+int crear_rwlock(char *nombre, int preferencia);
+int abrir_rwlock(char *nombre);
+int lock_lectura(unsigned int rwid);
+int lock_escritura(unsigned int rwid);
+int unlock_rw(unsigned int rwid);
+int cerrar_rwlock(unsigned int rwid);
+
+/*        SERVICIOS SEMAFOROS Y CONDICIONES        */
+int crear_semaforo(char *nombre, int valor);
+int abrir_semaforo(char *nombre);
+int wait_sem(unsigned int semid);
+int signal_sem(unsigned int semid);
+int cerrar_semaforo(unsigned int semid);
+int crear_condicion(char *nombre);
+int abrir_condicion(char *nombre);
+int wait_cond(unsigned int condid, unsigned int mutexid);
+int signal_cond(unsigned int condid);
+int broadcast_cond(unsigned int condid);
+int cerrar_condicion(unsigned int condid);
+int estadisticas_mutex(unsigned int n);
+
 
 /*
 * Variable global que contiene las rutinas que realizan cada llamada
@@ -172,11 +528,40 @@ servicio tabla_servicios[NSERVICIOS]={	{sis_crear_proceso},
 					{sis_escribir},
 					{obtener_id_pr},
 					{dormir},
+					{fijar_tiempo_real},
+					{esperar_periodo},
 					{crear_mutex},
 					{abrir_mutex},
 					{lock},
 					{unlock},
-					{cerrar_mutex}
+					{cerrar_mutex},
+					{fijar_prioridad},
+					{fijar_clase},
+					{crear_rwlock},
+					{abrir_rwlock},
+					{lock_lectura},
+					{lock_escritura},
+					{unlock_rw},
+					{cerrar_rwlock},
+					{crear_semaforo},
+					{abrir_semaforo},
+					{wait_sem},
+					{signal_sem},
+					{cerrar_semaforo},
+					{crear_condicion},
+					{abrir_condicion},
+					{wait_cond},
+					{signal_cond},
+					{broadcast_cond},
+					{cerrar_condicion},
+					{estadisticas_mutex},
+					{enviar_anillo},
+					{leer_caracter},
+					{leer},
+					{fijar_modo_terminal},
+					{leer_log},
+					{fijar_nivel_log},
+					{fijar_consola}
 					};
 
 #endif /* _KERNEL_H */
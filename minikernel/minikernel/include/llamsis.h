@@ -19,17 +19,46 @@
 #define _LLAMSIS_H
 
 /* Numero de llamadas disponibles */
-#define NSERVICIOS 10
+#define NSERVICIOS 39
 
 #define CREAR_PROCESO 0
 #define TERMINAR_PROCESO 1
 #define ESCRIBIR 2
 #define OBTENER_ID 3
 #define DORMIR 4
-#define CREAR_MUTEX 5
-#define ABRIR_MUTEX 6
-#define LOCK 7
-#define UNLOCK 8
-#define CERRAR_MUTEX 9
+#define FIJAR_TIEMPO_REAL 5
+#define ESPERAR_PERIODO 6
+#define CREAR_MUTEX 7
+#define ABRIR_MUTEX 8
+#define LOCK 9
+#define UNLOCK 10
+#define CERRAR_MUTEX 11
+#define FIJAR_PRIORIDAD 12
+#define FIJAR_CLASE 13
+#define CREAR_RWLOCK 14
+#define ABRIR_RWLOCK 15
+#define LOCK_LECTURA 16
+#define LOCK_ESCRITURA 17
+#define UNLOCK_RW 18
+#define CERRAR_RWLOCK 19
+#define CREAR_SEMAFORO 20
+#define ABRIR_SEMAFORO 21
+#define WAIT_SEM 22
+#define SIGNAL_SEM 23
+#define CERRAR_SEMAFORO 24
+#define CREAR_CONDICION 25
+#define ABRIR_CONDICION 26
+#define WAIT_COND 27
+#define SIGNAL_COND 28
+#define BROADCAST_COND 29
+#define CERRAR_CONDICION 30
+#define ESTADISTICAS_MUTEX 31
+#define ENVIAR_ANILLO 32
+#define LEER_CARACTER 33
+#define LEER 34
+#define FIJAR_MODO_TERMINAL 35
+#define LEER_LOG 36
+#define FIJAR_NIVEL_LOG 37
+#define FIJAR_CONSOLA 38
 
 #endif /* _LLAMSIS_H */
@@ -0,0 +1,36 @@
+/*
+ *  minikernel/kernel/include/pagina.h
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Fernando Pérez Costoya
+ *
+ */
+
+/*
+ *
+ * Fichero de cabecera que contiene la pagina de datos del nucleo que se
+ * publica a cada imagen: libserv la lee directamente para obtener el reloj,
+ * el id del proceso y su estado de planificacion sin llamadas al sistema.
+ *
+ */
+
+#ifndef _PAGINA_H
+#define _PAGINA_H
+
+/*
+ * Solo la escribe el nucleo. Protegida por un seqlock: secuencia es impar
+ * mientras se actualiza y cambia con cada actualizacion, asi que una copia
+ * es coherente si la secuencia era par y no ha cambiado al terminarla.
+ */
+typedef struct pagina_kernel_t {
+	volatile unsigned int secuencia;
+	volatile unsigned long ticks;	/* reloj del sistema */
+	volatile int id;		/* proceso en ejecucion */
+	volatile int prioridad;		/* efectiva, con la heredada */
+	volatile int clase;		/* CLASE_PRIORIDAD|CLASE_JUSTA|CLASE_TR */
+	volatile int rodaja;		/* ticks que le quedan de rodaja */
+	volatile int procs_vivos;	/* procesos en el sistema */
+} pagina_kernel;
+
+#endif /* _PAGINA_H */
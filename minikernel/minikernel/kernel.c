@@ -15,985 +15,3400 @@
 
 #include "kernel.h"	/* Contiene defs. usadas por este modulo */
 #include "string.h"
+#include "stdlib.h"
+#include "dlfcn.h"
+#include "stdio.h"
+#include "stdarg.h"
 
 /*
  *
  * Funciones relacionadas con la tabla de procesos:
- *	iniciar_tabla_proc buscar_BCP_libre
+ *	ampliar_tabla_proc iniciar_tabla_proc buscar_BCP_libre liberar_BCP
+ *	buscar_BCP
  *
+ * La tabla crece duplicando su tamaño. Los BCPs no se mueven al crecer,
+ * por lo que las listas pueden seguir apuntandolos. Las entradas libres
+ * forman una cola, de modo que reservar y liberar es de coste constante y
+ * una entrada liberada es la ultima en reutilizarse.
  */
 
 /*
- * Funci�n que inicia la tabla de procesos
+ * Añade un BCP al final de la cola de libres.
  */
-static void iniciar_tabla_proc(){
-	int i;
-
-	for (i=0; i<MAX_PROC; i++)
-		tabla_procs[i].estado=NO_USADA;
+static void encolar_BCP_libre(BCP * proc){
+	proc->siguiente=NULL;
+	if (procs_libres.primero==NULL)
+		procs_libres.primero=proc;
+	else
+		procs_libres.ultimo->siguiente=proc;
+	procs_libres.ultimo=proc;
 }
 
 /*
- * Funci�n que busca una entrada libre en la tabla de procesos
+ * Amplia la tabla de procesos hasta nuevo_tam entradas, añadiendo las
+ * nuevas a la cola de libres en orden. Devuelve -1 si no es posible.
  */
-static int buscar_BCP_libre(){
+static int ampliar_tabla_proc(int nuevo_tam){
+	BCP **nueva_tabla;
+	BCP *nuevos;
 	int i;
 
-	for (i=0; i<MAX_PROC; i++)
-		if (tabla_procs[i].estado==NO_USADA)
-			return i;
-	return -1;
-}
+	if (nuevo_tam>MAX_ENTRADAS_PROC)
+		nuevo_tam=MAX_ENTRADAS_PROC;
+	if (nuevo_tam<=tam_tabla_procs)
+		return -1;
 
+	nueva_tabla=realloc(tabla_procs, nuevo_tam*sizeof(BCP *));
+	if (nueva_tabla==NULL)
+		return -1;
+	tabla_procs=nueva_tabla;
 
- 
+	nuevos=malloc((nuevo_tam-tam_tabla_procs)*sizeof(BCP));
+	if (nuevos==NULL)
+		return -1;
 
+	/* el id inicial de cada entrada es su posicion (generacion 0) */
+	for (i=tam_tabla_procs; i<nuevo_tam; i++) {
+		tabla_procs[i]=&nuevos[i-tam_tabla_procs];
+		tabla_procs[i]->id=i;
+		tabla_procs[i]->estado=NO_USADA;
+		tabla_procs[i]->conj_descriptores=NULL;
+		tabla_procs[i]->lectura_desc=NULL;
+		tabla_procs[i]->tam_descriptores=0;
+		encolar_BCP_libre(tabla_procs[i]);
+	}
+	tam_tabla_procs=nuevo_tam;
+	return 0;
+}
 
 /*
- *
- * Funciones que facilitan el manejo de las listas de BCPs
- *	insertar_ultimo eliminar_primero eliminar_elem
- *
- * NOTA: PRIMERO SE DEBE LLAMAR A eliminar Y LUEGO A insertar
+ * Funci�n que inicia la tabla de procesos
  */
+static void iniciar_tabla_proc(){
+	if (ampliar_tabla_proc(MAX_PROC)<0)
+		panico("no hay memoria para la tabla de procesos");
+}
 
 /*
- * Inserta un BCP al final de la lista.
+ * Funci�n que obtiene una entrada libre en la tabla de procesos,
+ * ampliandola si no queda ninguna. Devuelve NULL si no es posible.
  */
-static void insertar_ultimo(lista_BCPs *lista, BCP * proc){
-	if (lista->primero==NULL){
-		lista->primero= proc;
-		}
-	else {
-		lista->ultimo->siguiente=proc;
-		}
-	lista->ultimo= proc;
-	proc->siguiente=NULL;
-}
+static BCP * buscar_BCP_libre(){
+	BCP * proc;
 
+	if (procs_libres.primero==NULL &&
+			ampliar_tabla_proc(2*tam_tabla_procs)<0)
+		return NULL;
 
+	proc=procs_libres.primero;
+	procs_libres.primero=proc->siguiente;
+	if (procs_libres.primero==NULL)
+		procs_libres.ultimo=NULL;
+	proc->siguiente=NULL;
+	num_procs_vivos++;
+	return proc;
+}
 
-/*++++++++++++++++ AÑADIDA POR NOSOTROS: INSERTAR PRIMERO "insertar_primero"++++++++++++++++++*/
 /*
-static void insertar_primero(lista_BCPs *lista, BCP *proc){
-	if(lista->primero != NULL) {
-		proc->siguiente = lista->primero;
-		}
-		
-	else {
-		proc->siguiente = NULL;
-		lista->ultimo = proc;
-		}
-	lista->primero = proc;
+ * Devuelve una entrada a la cola de libres avanzando su generacion, de
+ * modo que el id anterior deja de ser valido.
+ */
+static void liberar_BCP(BCP * proc){
+	proc->estado=NO_USADA;
+	proc->id=(proc->id+MAX_ENTRADAS_PROC)&MASCARA_ID_PROC;
+	encolar_BCP_libre(proc);
+	num_procs_vivos--;
+}
 
+/*
+ * Devuelve el BCP del proceso vivo con ese id, o NULL si el id no es
+ * valido o corresponde a un proceso ya terminado.
+ */
+BCP * buscar_BCP(int id){
+	int entrada;
+
+	if (id<0)
+		return NULL;
+	entrada=id&(MAX_ENTRADAS_PROC-1);
+	if (entrada>=tam_tabla_procs)
+		return NULL;
+	if (tabla_procs[entrada]->estado==NO_USADA ||
+			tabla_procs[entrada]->id!=id)
+		return NULL;
+	return tabla_procs[entrada];
 }
 
-*/
 
-// ↑↑ Tras un análisis, es probable que sea innecesario 
+ 
 
 
 /*
- * Elimina el primer BCP de la lista.
+ *
+ * Funciones relacionadas con la cache de pilas:
+ *	clase_pila reservar_pila devolver_pila iniciar_cache_pilas
+ *	informe_pilas
+ *
+ * Las pilas de los procesos terminados se guardan en la cache de su clase
+ * de tamaño para reutilizarlas, evitando pedir una pila nueva en cada
+ * creacion de proceso.
  */
-static void eliminar_primero(lista_BCPs *lista){
 
-	if (lista->ultimo==lista->primero)
-		lista->ultimo=NULL;
-	lista->primero=lista->primero->siguiente;
+/*
+ * Devuelve la clase de tamaño para una pila de tam bytes (como minimo
+ * TAM_PILA_MIN) o -1 si es demasiado grande.
+ */
+static int clase_pila(unsigned int tam){
+	int clase=0;
+
+	while ((TAM_PILA_MIN<<clase)<tam)
+		if (++clase==NUM_CLASES_PILA)
+			return -1;
+	return clase;
 }
 
 /*
- * Elimina un determinado BCP de la lista.
+ * Obtiene una pila de la clase indicada, de la cache si hay alguna.
  */
-static void eliminar_elem(lista_BCPs *lista, BCP * proc){
-	BCP *paux=lista->primero;
+static void * reservar_pila(int clase){
+	cache_pilas *cache=&caches_pilas[clase];
+	void *pila;
 
-	if (paux==proc)
-		eliminar_primero(lista);
-	else {
-		for ( ; ((paux) && (paux->siguiente!=proc));
-			paux=paux->siguiente);
-		if (paux) {
-			if (lista->ultimo==paux->siguiente)
-				lista->ultimo=paux;
-			paux->siguiente=paux->siguiente->siguiente;
-		}
+	if (cache->libres==NULL) {
+		cache->fallos++;
+		return crear_pila(TAM_PILA_MIN<<clase);
 	}
+	cache->aciertos++;
+	pila=cache->libres;
+	cache->libres=*(void **)pila;
+	cache->num--;
+	return pila;
 }
 
 /*
- *
- * Funciones relacionadas con la planificacion
- *	espera_int planificador
+ * Devuelve a la cache la pila de un proceso terminado. Si la cache de su
+ * clase esta llena, se libera.
  */
+static void devolver_pila(void *pila, int tam){
+	cache_pilas *cache=&caches_pilas[clase_pila(tam)];
+
+	if (cache->num==MAX_PILAS_CACHE) {
+		liberar_pila(pila);
+		return;
+	}
+	*(void **)pila=cache->libres;
+	cache->libres=pila;
+	cache->num++;
+}
 
 /*
- * Espera a que se produzca una interrupcion
+ * Llena la cache con num pilas de TAM_PILA.
  */
-static void espera_int(){
-	int nivel;
-
-	printk("-> NO HAY LISTOS. ESPERA INT\n");
-
-	/* Baja al m�nimo el nivel de interrupci�n mientras espera */
-	nivel=fijar_nivel_int(NIVEL_1);
-	halt();
-	fijar_nivel_int(nivel);
+static void iniciar_cache_pilas(int num){
+	void *pila;
+
+	while (num-- > 0 && caches_pilas[clase_pila(TAM_PILA)].num<MAX_PILAS_CACHE) {
+		pila=crear_pila(TAM_PILA);
+		if (pila==NULL)
+			break;
+		devolver_pila(pila, TAM_PILA);
+	}
 }
 
-
-
-
-
 /*
- * Funci�n de planificacion que implementa un algoritmo FIFO.
+ * Muestra los aciertos y fallos de las clases de pila usadas.
  */
-static BCP * planificador(){
-	while (lista_listos.primero==NULL)
-		espera_int();		/* No hay nada que hacer */
-	return lista_listos.primero;
+static void informe_pilas(){
+	int clase;
+
+	for (clase=0; clase<NUM_CLASES_PILA; clase++)
+		if (caches_pilas[clase].aciertos || caches_pilas[clase].fallos)
+			printk("-> PILAS DE %d: %lu ACIERTOS %lu FALLOS\n",
+				TAM_PILA_MIN<<clase, caches_pilas[clase].aciertos,
+				caches_pilas[clase].fallos);
 }
 
 /*
  *
- * Funcion auxiliar que termina proceso actual liberando sus recursos.
- * Usada por llamada terminar_proceso y por rutinas que tratan excepciones
+ * Funciones relacionadas con la cache de imagenes:
+ *	hash_cadena obtener_imagen soltar_imagen informe_imagenes
  *
+ * Los procesos que ejecutan el mismo programa comparten su imagen, que
+ * solo se carga al crear el primero y se libera al terminar el ultimo.
  */
-static void liberar_proceso(){
-	BCP * p_proc_anterior;
-
-	liberar_imagen(p_proc_actual->info_mem); /* liberar mapa */
 
-	p_proc_actual->estado=TERMINADO;
-	eliminar_primero(&lista_listos); /* proc. fuera de listos */
-
-	/* Realizar cambio de contexto */
-	p_proc_anterior=p_proc_actual;
-	p_proc_actual=planificador();
-
-	printk("-> C.CONTEXTO POR FIN: de %d a %d\n",
-			p_proc_anterior->id, p_proc_actual->id);
+/*
+ * Funcion hash (FNV-1a) de una cadena. Tambien la usan los nombres de
+ * mutex.
+ */
+static unsigned int hash_cadena(const char *cad){
+	unsigned int h=2166136261u;
 
-	liberar_pila(p_proc_anterior->pila);
-	cambio_contexto(NULL, &(p_proc_actual->contexto_regs));
-        return; /* no deber�a llegar aqui */
+	while (*cad) {
+		h^=(unsigned char)*cad++;
+		h*=16777619u;
+	}
+	return h;
 }
 
-
 /*
-Funcion auxiliar que inicializa la tabla de mutex
+ * Devuelve la imagen del programa prog con una referencia mas, cargandola
+ * si ningun proceso la usa. Devuelve NULL si no se puede cargar.
+ */
+static IMAGENptr obtener_imagen(char *prog){
+	IMAGENptr *entrada=&tabla_imagenes[hash_cadena(prog)&(TAM_TABLA_IMAGENES-1)];
+	IMAGENptr img;
+
+	for (img=*entrada; img; img=img->siguiente)
+		if (strcmp(img->nombre, prog)==0) {
+			imagenes_aciertos++;
+			img->referencias++;
+			return img;
+		}
 
-*/
-void iniciar_tabla_mut(){
-	
-	for(int i=0; i<NUM_MUT;i++){
-	
-		lista_mut[i].estado = LIBRE;
-		lista_mut[i].lista_mut_espera.primero = NULL;
-		lista_mut[i].n_mut_espera = 0;
-		lista_mut[i].id_poseedor_mut = -1;
-		lista_mut[i].num_mut_bloqueos = 0;
-		lista_mut[i].estado_bloqueo_mut = MUT_DESBLOQUEADO; 
-		
-	
+	imagenes_fallos++;
+	img=malloc(sizeof(imagen_prog));
+	if (img==NULL)
+		return NULL;
+	img->nombre=malloc(strlen(prog)+1);
+	if (img->nombre==NULL) {
+		free(img);
+		return NULL;
 	}
+	img->info_mem=crear_imagen(prog, &(img->pc_inicial));
+	if (img->info_mem==NULL) {
+		free(img->nombre);
+		free(img);
+		return NULL;
+	}
+	/* la copia de libserv de la imagen accede a la zona de futex y
+	   a la pagina de datos del nucleo */
+	zona_futex **zona=dlsym(img->info_mem, "zona_kernel");
+	if (zona)
+		*zona=&zona_usuario;
+	const pagina_kernel **pagina=dlsym(img->info_mem, "pagina_datos");
+	if (pagina)
+		*pagina=&pagina_nucleo;
+	strcpy(img->nombre, prog);
+	img->referencias=1;
+	img->siguiente=*entrada;
+	*entrada=img;
+	return img;
+}
 
-
+/*
+ * Quita una referencia a la imagen y la libera si era la ultima.
+ * NOTA: al liberar la ultima imagen del sistema finaliza la ejecucion.
+ */
+static void soltar_imagen(IMAGENptr img){
+	IMAGENptr *p;
+
+	if (--img->referencias>0)
+		return;
+
+	for (p=&tabla_imagenes[hash_cadena(img->nombre)&(TAM_TABLA_IMAGENES-1)];
+			*p!=img; p=&((*p)->siguiente));
+	*p=img->siguiente;
+	free(img->nombre);
+	liberar_imagen(img->info_mem);
+	free(img);
 }
 
+/*
+ * Muestra los aciertos y fallos de la cache de imagenes.
+ */
+static void informe_imagenes(){
+	printk("-> IMAGENES: %lu ACIERTOS %lu FALLOS\n",
+		imagenes_aciertos, imagenes_fallos);
+}
 
 /*
  *
- * Funciones relacionadas con el tratamiento de interrupciones
- *	excepciones: exc_arit exc_mem
- *	interrupciones de reloj: int_reloj
- *	interrupciones del terminal: int_terminal
- *	llamadas al sistemas: llam_sis
- *	interrupciones SW: int_sw
+ * Funciones que facilitan el manejo de las listas de BCPs
+ *	insertar_ultimo eliminar_primero eliminar_elem
  *
- * 
- *  Añadir a la rutina de interrupción la detección de si se cumple el plazo de
- *	algún proceso dormido. Si es así, debe cambiarle de estado y reajustar las
- *	listas correspondientes
+ * Las listas son doblemente enlazadas y cada BCP sabe en que lista esta,
+ * por lo que todas las operaciones son de coste constante. Compilando con
+ * DEPURAR_COLAS se comprueba que un BCP no este en dos colas a la vez.
  *
+ * NOTA: PRIMERO SE DEBE LLAMAR A eliminar Y LUEGO A insertar
  */
 
+#ifdef DEPURAR_COLAS
+#define comprobar_cola(cond, msj) do { if (!(cond)) panico(msj); } while (0)
+#else
+#define comprobar_cola(cond, msj) do { } while (0)
+#endif
+
 /*
- * Tratamiento de excepciones aritmeticas
+ * Inserta un BCP al final de la lista.
  */
-static void exc_arit(){
+static void insertar_ultimo(lista_BCPs *lista, BCP * proc){
+	comprobar_cola(proc->lista==NULL && proc->pos_monticulo<0,
+		"insertar_ultimo: BCP ya en una cola");
 
-	if (!viene_de_modo_usuario())
-		panico("excepcion aritmetica cuando estaba dentro del kernel");
+	proc->anterior=lista->ultimo;
+	proc->siguiente=NULL;
+	if (lista->primero==NULL)
+		lista->primero=proc;
+	else
+		lista->ultimo->siguiente=proc;
+	lista->ultimo=proc;
+	proc->lista=lista;
+}
 
+/*
+ * Elimina un determinado BCP de la lista.
+ */
+static void eliminar_elem(lista_BCPs *lista, BCP * proc){
+	comprobar_cola(proc->lista==lista, "eliminar_elem: BCP en otra cola");
 
-	printk("-> EXCEPCION ARITMETICA EN PROC %d\n", p_proc_actual->id);
-	liberar_proceso();
+	if (proc->anterior)
+		proc->anterior->siguiente=proc->siguiente;
+	else
+		lista->primero=proc->siguiente;
+	if (proc->siguiente)
+		proc->siguiente->anterior=proc->anterior;
+	else
+		lista->ultimo=proc->anterior;
+	proc->siguiente=proc->anterior=NULL;
+	proc->lista=NULL;
+}
 
-        return; /* no deber�a llegar aqui */
+/*
+ * Elimina el primer BCP de la lista.
+ */
+static void eliminar_primero(lista_BCPs *lista){
+	eliminar_elem(lista, lista->primero);
 }
 
 /*
- * Tratamiento de excepciones en el acceso a memoria
+ *
+ * Funciones que manejan un monticulo de BCPs
+ *	monticulo_insertar monticulo_eliminar monticulo_recolocar
+ *
+ * Monticulo binario de minimos ordenado por la funcion "menor" del propio
+ * monticulo. Cada BCP guarda su posicion, por lo que eliminar o recolocar
+ * uno cualquiera es O(log n). Un BCP solo puede estar en un monticulo.
  */
-static void exc_mem(){
 
-	if (!viene_de_modo_usuario())
-		panico("excepcion de memoria cuando estaba dentro del kernel");
+static void monticulo_colocar(monticulo_BCPs *mont, int pos, BCP * proc){
+	mont->elem[pos]=proc;
+	proc->pos_monticulo=pos;
+}
 
+static void monticulo_subir(monticulo_BCPs *mont, int pos){
+	BCP * proc=mont->elem[pos];
 
-	printk("-> EXCEPCION DE MEMORIA EN PROC %d\n", p_proc_actual->id);
-	liberar_proceso();
+	while (pos>0 && mont->menor(proc, mont->elem[(pos-1)/2])) {
+		monticulo_colocar(mont, pos, mont->elem[(pos-1)/2]);
+		pos=(pos-1)/2;
+	}
+	monticulo_colocar(mont, pos, proc);
+}
 
-        return; /* no deber�a llegar aqui */
+static void monticulo_bajar(monticulo_BCPs *mont, int pos){
+	BCP * proc=mont->elem[pos];
+	int hijo;
+
+	while ((hijo=2*pos+1)<mont->num) {
+		if (hijo+1<mont->num &&
+				mont->menor(mont->elem[hijo+1], mont->elem[hijo]))
+			hijo++;
+		if (!mont->menor(mont->elem[hijo], proc))
+			break;
+		monticulo_colocar(mont, pos, mont->elem[hijo]);
+		pos=hijo;
+	}
+	monticulo_colocar(mont, pos, proc);
 }
 
 /*
- * Tratamiento de interrupciones de terminal
+ * Inserta un BCP en el monticulo, ampliandolo si esta lleno.
  */
-static void int_terminal(){
-	char car;
+static void monticulo_insertar(monticulo_BCPs *mont, BCP * proc){
+	BCP **elem;
+
+	comprobar_cola(proc->lista==NULL && proc->pos_monticulo<0,
+		"monticulo_insertar: BCP ya en una cola");
+
+	if (mont->num==mont->capacidad) {
+		elem=realloc(mont->elem, 2*(mont->capacidad+1)*sizeof(BCP *));
+		if (elem==NULL)
+			panico("sin memoria para el monticulo de listos");
+		mont->elem=elem;
+		mont->capacidad=2*(mont->capacidad+1);
+	}
+	mont->elem[mont->num]=proc;
+	monticulo_subir(mont, mont->num++);
+}
 
-	car = leer_puerto(DIR_TERMINAL);
-	printk("-> TRATANDO INT. DE TERMINAL %c\n", car);
+/*
+ * Restablece la posicion de un BCP cuya clave ha cambiado.
+ */
+static void monticulo_recolocar(monticulo_BCPs *mont, BCP * proc){
+	monticulo_subir(mont, proc->pos_monticulo);
+	monticulo_bajar(mont, proc->pos_monticulo);
+}
 
-        return;
+/*
+ * Elimina un BCP cualquiera del monticulo.
+ */
+static void monticulo_eliminar(monticulo_BCPs *mont, BCP * proc){
+	int pos=proc->pos_monticulo;
+	BCP * ultimo;
+
+	comprobar_cola(pos>=0 && pos<mont->num && mont->elem[pos]==proc,
+		"monticulo_eliminar: BCP en otra cola");
+
+	proc->pos_monticulo=-1;
+	if (--mont->num==pos)
+		return;
+	ultimo=mont->elem[mont->num];
+	monticulo_colocar(mont, pos, ultimo);
+	monticulo_recolocar(mont, ultimo);
 }
 
-/* funcion auxiliar para la llamada dormir, actualiza los tiempos de los procesos dormidos */ 
-void restarTiempoBloqueados(){ 
- 
-	BCPptr aux = lista_bloqueados.primero; 
+/*
+ *
+ * Funciones que manejan la cola de listos
+ *	insertar_listo eliminar_listo primer_listo contabilizar_tick
+ *
+ * Los procesos de CLASE_TR estan en un monticulo ordenado por plazo
+ * absoluto (EDF). Los de CLASE_PRIORIDAD estan en una lista por nivel de
+ * prioridad, con un mapa de bits que indica que niveles tienen algun
+ * proceso. Los de CLASE_JUSTA estan en un monticulo ordenado por tiempo
+ * virtual de ejecucion. Cada clase solo ejecuta si las anteriores no
+ * tienen ningun proceso listo.
+ */
 
-	/* recorro la lista y actualizo los tiempos */ 
+/* orden entre clases: menor valor, mas preferente */
+static const int rango_clase[]={1, 2, 0};
 
-	while(aux != NULL){ 
-		BCPptr siguiente = aux->siguiente; 
-		aux->tiempo_dormir--; 
+/*
+ * Orden del monticulo de procesos de CLASE_JUSTA.
+ */
+static int justo_menor(BCP * a, BCP * b){
+	return a->vruntime<b->vruntime;
+}
 
-		if(aux->tiempo_dormir == 0){ 
-			aux->estado = LISTO; 
-			eliminar_elem(&lista_bloqueados, aux); 
-			insertar_ultimo(&lista_listos, aux); 
-	} 
-		aux = siguiente; 
-	} 
-} 
+/*
+ * Orden del monticulo de procesos de CLASE_TR.
+ */
+static int tr_menor(BCP * a, BCP * b){
+	return a->plazo_abs<b->plazo_abs;
+}
 
+/*
+ * Devuelve verdadero si el proceso a debe expulsar al proceso b.
+ */
+static int debe_expulsar(BCP * a, BCP * b){
+	if (a->clase!=b->clase)
+		return rango_clase[a->clase]<rango_clase[b->clase];
+	if (a->clase==CLASE_TR)
+		return a->plazo_abs<b->plazo_abs;
+	if (a->clase==CLASE_JUSTA)
+		return a->vruntime+GRANULARIDAD_JUSTA<=b->vruntime;
+	return a->prioridad<b->prioridad;
+}
 
+/*
+ * Pide expulsar al proceso actual en la proxima interrupcion software.
+ * Solo se cambia de contexto en int_sw, nunca en otros manejadores.
+ */
+static void pedir_replanificacion(){
+	p_proc_expulsar=p_proc_actual;
+	activar_int_SW();
+}
 
+/*
+ * Inserta un BCP en la cola de listos: al final del nivel de su prioridad
+ * o en el monticulo de su clase. Un proceso justo que vuelve de estar
+ * bloqueado conserva como mucho CREDITO_DORMIDO ticks de ventaja sobre el
+ * minimo. Uno de tiempo real sin presupuesto queda estrangulado hasta su
+ * siguiente periodo. Si debe expulsar al proceso en ejecucion, lo pide.
+ */
+static void insertar_listo(BCP * proc){
+	if (proc->clase==CLASE_TR) {
+		if (proc->estrangulado) {
+			proc->estado=ESTRANGULADO;
+			return;
+		}
+		monticulo_insertar(&cola_tr, proc);
+	}
+	else if (proc->clase==CLASE_JUSTA) {
+		if (proc->vruntime+CREDITO_DORMIDO<vruntime_min)
+			proc->vruntime=vruntime_min-CREDITO_DORMIDO;
+		monticulo_insertar(&cola_justos, proc);
+	}
+	else {
+		insertar_ultimo(&(lista_listos.nivel[proc->prioridad]), proc);
+		lista_listos.mapa|=1U<<proc->prioridad;
+	}
 
+	if (p_proc_actual && p_proc_actual!=proc &&
+			p_proc_actual->estado==LISTO &&
+			debe_expulsar(proc, p_proc_actual))
+		pedir_replanificacion();
+}
 
 /*
- * Tratamiento de interrupciones de reloj
+ * Elimina un BCP de la cola de listos.
  */
-static void int_reloj(){
-
-	printk("-> TRATANDO INT. DE RELOJ\n");
+static void eliminar_listo(BCP * proc){
+	lista_BCPs *nivel;
 
-	restarTiempoBloqueados();
-        return;
+	if (proc->clase==CLASE_TR) {
+		monticulo_eliminar(&cola_tr, proc);
+		return;
+	}
+	if (proc->clase==CLASE_JUSTA) {
+		monticulo_eliminar(&cola_justos, proc);
+		return;
+	}
+	nivel=&(lista_listos.nivel[proc->prioridad]);
+	eliminar_elem(nivel, proc);
+	if (nivel->primero==NULL)
+		lista_listos.mapa&=~(1U<<proc->prioridad);
 }
 
 /*
- * Tratamiento de llamadas al sistema
+ * Devuelve el siguiente BCP a ejecutar o NULL si no hay listos.
  */
-static void tratar_llamsis(){
-	int nserv, res;
-
-	nserv=leer_registro(0);
-	if (nserv<NSERVICIOS)
-		res=(tabla_servicios[nserv].fservicio)();
-	else
-		res=-1;		/* servicio no existente */
-	escribir_registro(0,res);
-	return;
+static BCP * primer_listo(){
+	if (cola_tr.num)
+		return cola_tr.elem[0];
+	if (lista_listos.mapa)
+		return lista_listos.nivel[__builtin_ctz(lista_listos.mapa)].primero;
+	if (cola_justos.num==0)
+		return NULL;
+	if (cola_justos.elem[0]->vruntime>vruntime_min)
+		vruntime_min=cola_justos.elem[0]->vruntime;
+	return cola_justos.elem[0];
 }
 
 /*
- * Tratamiento de interrupciuones software
+ * Carga un tick al proceso en ejecucion y pide expulsarlo si ha agotado
+ * su rodaja, en CLASE_TR si ha agotado su presupuesto o, en CLASE_JUSTA,
+ * si supera en GRANULARIDAD_JUSTA el tiempo virtual del primero del
+ * monticulo.
  */
-static void int_sw(){
+static void contabilizar_tick(BCP * proc){
+	if (proc->clase==CLASE_TR) {
+		if (proc->presupuesto_rest>0)
+			proc->presupuesto_rest--;
+		if (proc->presupuesto_rest==0 && !proc->estrangulado) {
+			proc->estrangulado=1;
+			pedir_replanificacion();
+		}
+	}
+	else if (proc->clase==CLASE_JUSTA) {
+		proc->vruntime++;
+		monticulo_recolocar(&cola_justos, proc);
+		if (debe_expulsar(cola_justos.elem[0], proc))
+			pedir_replanificacion();
+	}
+	else if (--proc->rodaja<=0)
+		pedir_replanificacion();
+}
 
-	printk("-> TRATANDO INT. SW\n");
+/*
+ *
+ * Funciones que gestionan la rueda jerarquica de temporizadores
+ *	iniciar_temporizador armar_temporizador cancelar_temporizador
+ *	avanzar_rueda
+ *
+ * Cada nivel tiene RUEDA_RANURAS ranuras; el nivel n cubre plazos de hasta
+ * RUEDA_RANURAS^(n+1) ticks. Armar y cancelar son O(1) y un temporizador
+ * solo se recoloca al bajar de nivel (cascada), como mucho una vez por
+ * nivel. Deben invocarse con las interrupciones de reloj inhibidas.
+ */
 
-	return;
+/*
+ * Encola un temporizador en la ranura que corresponde a su expiracion
+ * respecto al siguiente tick que procesara la rueda.
+ */
+static void encolar_temporizador(TEMPptr temp){
+	unsigned long expiracion=temp->expiracion;
+	long dif=(long)(expiracion-rueda_base);
+	int nivel=0;
+	TEMPptr *ranura;
+
+	if (dif<0)	/* ya vencido: se procesa en el siguiente tick */
+		expiracion=rueda_base;
+	else if (dif>=(1L<<(RUEDA_BITS*RUEDA_NIVELES))) {
+		/* fuera de rango: se recoloca al llegar al ultimo nivel */
+		dif=(1L<<(RUEDA_BITS*RUEDA_NIVELES))-1;
+		expiracion=rueda_base+dif;
+	}
+	while (dif>=(1L<<(RUEDA_BITS*(nivel+1))))
+		nivel++;
+
+	ranura=&rueda_temp[nivel][(expiracion>>(RUEDA_BITS*nivel))&RUEDA_MASCARA];
+	temp->anterior=NULL;
+	temp->siguiente=*ranura;
+	if (*ranura)
+		(*ranura)->anterior=temp;
+	*ranura=temp;
+	temp->ranura=ranura;
 }
 
+/*
+ * Prepara un temporizador que invocara funcion(arg) al vencer.
+ */
+static void iniciar_temporizador(TEMPptr temp, void (*funcion)(void *),
+		void *arg){
+	temp->funcion=funcion;
+	temp->arg=arg;
+	temp->siguiente=temp->anterior=NULL;
+	temp->ranura=NULL;
+}
 
+/*
+ * Desactiva un temporizador. No hace nada si no estaba armado.
+ */
+static void cancelar_temporizador(TEMPptr temp){
+	if (temp->ranura==NULL)
+		return;
+	if (temp->anterior)
+		temp->anterior->siguiente=temp->siguiente;
+	else
+		*(temp->ranura)=temp->siguiente;
+	if (temp->siguiente)
+		temp->siguiente->anterior=temp->anterior;
+	temp->ranura=NULL;
+}
 
-/*Añadir a la rutina de interrupción la detección de si se cumple el plazo de
-algún proceso dormido. Si es así, debe cambiarle de estado y reajustar las
-listas correspondientes*/
-
+/*
+ * Arma (o rearma) un temporizador para el tick absoluto indicado.
+ */
+static void armar_temporizador(TEMPptr temp, unsigned long expiracion){
+	cancelar_temporizador(temp);
+	temp->expiracion=expiracion;
+	encolar_temporizador(temp);
+}
 
+/*
+ * Vacia una ranura de un nivel superior recolocando sus temporizadores.
+ * Devuelve el indice de la ranura para encadenar la cascada.
+ */
+static int cascada(int nivel, int indice){
+	TEMPptr temp=rueda_temp[nivel][indice];
+	TEMPptr sig;
+
+	rueda_temp[nivel][indice]=NULL;
+	for ( ; temp; temp=sig) {
+		sig=temp->siguiente;
+		encolar_temporizador(temp);
+	}
+	return indice;
+}
 
+/*
+ * Procesa los ticks pendientes hasta ticks_sistema ejecutando los
+ * temporizadores vencidos.
+ */
+static void avanzar_rueda(){
+	TEMPptr temp;
+	int indice, nivel, ind_nivel;
+
+	while (rueda_base<=ticks_sistema) {
+		indice=rueda_base&RUEDA_MASCARA;
+		ind_nivel=indice;
+		for (nivel=1; ind_nivel==0 && nivel<RUEDA_NIVELES; nivel++)
+			ind_nivel=cascada(nivel,
+				(rueda_base>>(RUEDA_BITS*nivel))&RUEDA_MASCARA);
+		rueda_base++;
+
+		while ((temp=rueda_temp[0][indice])!=NULL) {
+			cancelar_temporizador(temp);
+			(temp->funcion)(temp->arg);
+		}
+	}
+}
 
+/*
+ *
+ * Funciones relacionadas con la clase de tiempo real
+ *	nuevo_periodo entrar_tiempo_real salir_tiempo_real
+ *
+ * Cada proceso de CLASE_TR declara periodo, presupuesto y plazo relativo
+ * (en ticks). Al comienzo de cada periodo un temporizador renueva su
+ * presupuesto y fija su plazo absoluto; si lo agota antes, queda
+ * estrangulado (ESTRANGULADO) hasta el siguiente periodo. Solo se admite
+ * si la suma de densidades presupuesto/plazo no supera UTILIZACION_MAX_TR.
+ */
 
+/*
+ * Comienza un nuevo periodo del proceso de tiempo real.
+ */
+static void nuevo_periodo(void *arg){
+	BCP * proc=(BCP *)arg;
+	unsigned long inicio=proc->temp_periodo.expiracion;
+
+	proc->presupuesto_rest=proc->presupuesto;
+	proc->plazo_abs=inicio+proc->plazo;
+	proc->estrangulado=0;
+	armar_temporizador(&(proc->temp_periodo), inicio+proc->periodo);
+
+	if (proc->estado==ESTRANGULADO) {
+		proc->estado=LISTO;
+		insertar_listo(proc);
+	}
+	else if (proc->pos_monticulo>=0)
+		monticulo_recolocar(&cola_tr, proc);
+}
+
+/*
+ * Pasa a CLASE_TR un proceso que no esta en la cola de listos, comenzando
+ * su primer periodo en el tick actual.
+ */
+static void entrar_tiempo_real(BCP * proc, unsigned long periodo,
+		unsigned long presupuesto, unsigned long plazo, int densidad){
+	proc->clase=CLASE_TR;
+	proc->periodo=periodo;
+	proc->presupuesto=presupuesto;
+	proc->plazo=plazo;
+	proc->densidad=densidad;
+	utilizacion_tr+=densidad;
+
+	proc->presupuesto_rest=presupuesto;
+	proc->plazo_abs=ticks_sistema+plazo;
+	proc->estrangulado=0;
+	armar_temporizador(&(proc->temp_periodo), ticks_sistema+periodo);
+}
 
+/*
+ * Saca de CLASE_TR a un proceso que no esta en la cola de listos,
+ * devolviendo su utilizacion.
+ */
+static void salir_tiempo_real(BCP * proc){
+	cancelar_temporizador(&(proc->temp_periodo));
+	utilizacion_tr-=proc->densidad;
+	proc->densidad=0;
+	proc->estrangulado=0;
+	proc->clase=CLASE_PRIORIDAD;
+}
+
+/*
+ *
+ * Funciones relacionadas con el reloj dinamico
+ *	ticks_hasta_vencimiento recuperar_ticks ralentizar_reloj
+ *	salir_reloj_ocioso
+ *
+ * Con la UCP ociosa, el reloj se reprograma a la menor frecuencia que no
+ * retrase el siguiente vencimiento de la rueda y cada interrupcion cuenta
+ * por varios ticks. Al volver a haber listos se recuperan con el reloj
+ * CMOS los ticks de la fraccion de periodo transcurrida y se restaura TICK.
+ */
 
+/*
+ * Devuelve cuantos ticks pueden omitirse sin retrasar ningun temporizador.
+ * Los niveles superiores de la rueda solo se recolocan al dar la vuelta el
+ * nivel 0, por lo que basta con no pasar de ese punto si tienen alguno.
+ */
+static unsigned long ticks_hasta_vencimiento(){
+	unsigned long proximo=rueda_base+TICK;
+	int indice=rueda_base&RUEDA_MASCARA;
+	int i, nivel;
+
+	for (i=0; i<RUEDA_RANURAS; i++)
+		if (rueda_temp[0][(indice+i)&RUEDA_MASCARA]) {
+			if (rueda_base+i<proximo)
+				proximo=rueda_base+i;
+			break;
+		}
+	for (nivel=1; nivel<RUEDA_NIVELES; nivel++)
+		for (i=0; i<RUEDA_RANURAS; i++)
+			if (rueda_temp[nivel][i]) {
+				if (rueda_base+((RUEDA_RANURAS-indice)&RUEDA_MASCARA)<proximo)
+					proximo=rueda_base+((RUEDA_RANURAS-indice)&RUEDA_MASCARA);
+				nivel=RUEDA_NIVELES;
+				break;
+			}
+	return (proximo>ticks_sistema) ? proximo-ticks_sistema : 0;
+}
 
+/*
+ * Ajusta ticks_sistema al tiempo real transcurrido desde que la UCP
+ * quedo ociosa.
+ */
+static void recuperar_ticks(){
+	unsigned long reales;
 
+	reales=ticks_ref_ocioso+
+		(unsigned long)((leer_reloj_CMOS()-ms_ref_ocioso)*TICK/1000);
+	if (reales>ticks_sistema)
+		ticks_sistema=reales;
+}
 
+/*
+ * Programa el reloj para que cada interrupcion cubra el mayor divisor de
+ * TICK que no supere los ticks indicados.
+ */
+static void ralentizar_reloj(unsigned long ticks){
+	int k=(ticks>TICK) ? TICK : ((ticks>0) ? ticks : 1);
+
+	while (TICK%k)
+		k--;
+	if (k!=ticks_por_int) {
+		recuperar_ticks();
+		ticks_por_int=k;
+		iniciar_cont_reloj(TICK/k);
+	}
+}
+
+/*
+ * Sale del modo ocioso recuperando los ticks pendientes y restaurando
+ * la frecuencia normal del reloj.
+ */
+static void salir_reloj_ocioso(){
+	int nivel;
+
+	nivel=fijar_nivel_int(NIVEL_3);
+	recuperar_ticks();
+	avanzar_rueda();
+	reloj_ocioso=0;
+	if (ticks_por_int!=1) {
+		ticks_por_int=1;
+		iniciar_cont_reloj(TICK);
+	}
+	fijar_nivel_int(nivel);
+}
 
 /*
  *
- * Funcion auxiliar que crea un proceso reservando sus recursos.
- * Usada por llamada crear_proceso.
- *
+ * Funciones relacionadas con la planificacion
+ *	espera_int planificador
  */
-static int crear_tarea(char *prog){
-	void * imagen, *pc_inicial;
-	int error=0;
-	int proc;
-	BCP *p_proc;
 
-	proc=buscar_BCP_libre();
-	if (proc==-1)
-		return -1;	/* no hay entrada libre */
+/*
+ * Espera a que se produzca una interrupcion
+ */
+static void espera_int(){
+	int nivel;
 
-	/* A rellenar el BCP ... */
-	p_proc=&(tabla_procs[proc]);
+	volcar_log();		/* aprovecha que la UCP esta ociosa */
+	vaciar_consola();
+	nivel=fijar_nivel_int(NIVEL_3);
+	if (!reloj_ocioso)
+		registrar(LOG_DEPURACION, "-> NO HAY LISTOS. ESPERA INT\n");
+
+	/* Omite los ticks hasta el siguiente vencimiento */
+	if (reloj_dinamico) {
+		if (!reloj_ocioso) {
+			reloj_ocioso=1;
+			ms_ref_ocioso=leer_reloj_CMOS();
+			ticks_ref_ocioso=ticks_sistema;
+		}
+		ralentizar_reloj(ticks_hasta_vencimiento());
+	}
 
-	/* crea la imagen de memoria leyendo ejecutable */
-	imagen=crear_imagen(prog, &pc_inicial);
-	if (imagen)
-	{
-		p_proc->info_mem=imagen;
-		p_proc->pila=crear_pila(TAM_PILA);
-		fijar_contexto_ini(p_proc->info_mem, p_proc->pila, TAM_PILA,
-			pc_inicial,
-			&(p_proc->contexto_regs));
-		p_proc->id=proc;
-		p_proc->estado=LISTO;
-		//para dormir
-		p_proc->tiempo_dormir=0;
-		
-		//para mutex: inicializar los descriptores y por consecuencia el contador de descriptores usados
-		for(int i=0; i < NUM_MUT_PROC ; i++) p_proc->conj_descriptores[i] = -1;
-		p_proc->n_descriptores_usados = 0;
-		
+	/* Baja al m�nimo el nivel de interrupci�n mientras espera */
+	fijar_nivel_int(NIVEL_1);
+	halt();
+	fijar_nivel_int(nivel);
+}
 
-		/* lo inserta al final de cola de listos */
-		insertar_ultimo(&lista_listos, p_proc);
-		error= 0;
+
+
+
+
+/*
+ * Funcion de planificacion: el proceso de tiempo real con el plazo mas
+ * cercano, si no hay ninguno round-robin por prioridades y, si tampoco,
+ * el proceso justo con menor tiempo virtual. Renueva la rodaja del
+ * elegido si la tenia agotada.
+ */
+static BCP * planificador(){
+	BCP * proc;
+
+	while (cola_tr.num==0 && lista_listos.mapa==0 && cola_justos.num==0)
+		espera_int();		/* No hay nada que hacer */
+	if (reloj_ocioso)
+		salir_reloj_ocioso();
+	proc=primer_listo();
+	if (proc->rodaja<=0)
+		proc->rodaja=TICKS_POR_RODAJA;
+	publicar_zona_futex(proc);
+	publicar_pagina(proc);
+	return proc;
+}
+
+/*
+ * Cede la UCP si el proceso actual ha dejado de ser el listo mas prioritario.
+ */
+static void replanificar(){
+	BCPptr actual = p_proc_actual;
+
+	p_proc_actual = planificador();
+	if (p_proc_actual != actual) {
+		registrar(LOG_DEPURACION, "-> C.CONTEXTO POR EXPULSION: de %d a %d\n",
+				actual->id, p_proc_actual->id);
+		cambio_contexto(&(actual->contexto_regs), &(p_proc_actual->contexto_regs));
 	}
-	else
-		error= -1; /* fallo al crear imagen */
+}
 
-	return error;
+/*
+ * Muestra las estadisticas del sistema. Se invoca al terminar el ultimo
+ * proceso, ya que al liberar su imagen finaliza la ejecucion. Los informes
+ * se escriben directamente, tras la salida pendiente.
+ */
+static void informe_final(){
+	vaciar_salida();
+	informe_pilas();
+	informe_imagenes();
+	printk("-> HERENCIA DE PRIORIDAD: %lu ELEVACIONES %lu TICKS\n",
+		num_elevaciones, ticks_elevados);
+	if (lockstat_top > 0)
+		informe_lockstat(lockstat_top);
+	printk("-> TERMINAL: %lu CARACTERES PERDIDOS\n", car_perdidos);
+	printk("-> LOG: %lu MENSAJES PERDIDOS\n", log_perdidos);
+	printk("-> CONSOLA: %lu ESCRITURAS PARA %lu LLAMADAS\n",
+		escrituras_consola, llamadas_escribir);
 }
 
 /*
  *
- * Rutinas que llevan a cabo las llamadas al sistema
- *	sis_crear_proceso sis_escribir
+ * Funcion auxiliar que termina proceso actual liberando sus recursos.
+ * Usada por llamada terminar_proceso y por rutinas que tratan excepciones
  *
  */
+static void liberar_proceso(){
+	BCP * p_proc_anterior;
+
+	cerrar_descriptores_mutex(p_proc_actual); /* cierre implicito */
+	pasar_linea(p_proc_actual);	/* lo que haya escrito sin salto */
+	if (linea_cortada == p_proc_actual)
+		encolar_consola(p_proc_actual, "\n", 1);
+
+	if (num_procs_vivos==1)
+		informe_final();
+	soltar_imagen(p_proc_actual->imagen); /* liberar mapa */
+
+	p_proc_actual->estado=TERMINADO;
+	eliminar_listo(p_proc_actual); /* proc. fuera de listos */
+	if (p_proc_actual->clase==CLASE_TR)
+		salir_tiempo_real(p_proc_actual);
+
+	/* Realizar cambio de contexto */
+	p_proc_anterior=p_proc_actual;
+	p_proc_actual=planificador();
+
+	registrar(LOG_DEPURACION, "-> C.CONTEXTO POR FIN: de %d a %d\n",
+			p_proc_anterior->id, p_proc_actual->id);
+
+	devolver_pila(p_proc_anterior->pila, p_proc_anterior->tam_pila);
+	liberar_BCP(p_proc_anterior);
+	cambio_contexto(NULL, &(p_proc_actual->contexto_regs));
+        return; /* no deber�a llegar aqui */
+}
+
 
 /*
- * Tratamiento de llamada al sistema crear_proceso. Llama a la
- * funcion auxiliar crear_tarea sis_terminar_proceso
+ * Devuelve el valor del parametro de arranque "nombre" de la variable de
+ * entorno VAR_ARRANQUE ("nombre=valor ...") o el valor por defecto si no
+ * aparece.
  */
-int sis_crear_proceso(){
-	char *prog;
-	int res;
+static int parametro_arranque(const char *nombre, int defecto){
+	char *args=getenv(VAR_ARRANQUE);
+	int lon=strlen(nombre);
+
+	while (args && *args) {
+		while (*args==' ')
+			args++;
+		if (strncmp(args, nombre, lon)==0 && args[lon]=='=')
+			return atoi(args+lon+1);
+		while (*args && *args!=' ')
+			args++;
+	}
+	return defecto;
+}
 
-	printk("-> PROC %d: CREAR PROCESO\n", p_proc_actual->id);
-	prog=(char *)leer_registro(1);
-	res=crear_tarea(prog);
-	return res;
+//nombre de cada primitiva para los mensajes
+static char *nombre_primitiva[] = {"Mutex", "Rwlock", "Semaforo", "Condicion"};
+
+//comprueba el tipo con el que se crea un objeto: RECURSIVO|NO_RECURSIVO para
+//un mutex, la preferencia para un rwlock y el valor inicial para un semaforo
+int tipo_valido(int primitiva, int tipo){
+	switch (primitiva) {
+	case PRIM_MUTEX:
+		return tipo == NO_RECURSIVO || tipo == RECURSIVO;
+	case PRIM_RW:
+		return tipo == RW_PREF_LECTORES || tipo == RW_PREF_ESCRITORES;
+	case PRIM_SEM:
+		return tipo >= 0;
+	default:
+		return 1;
+	}
 }
 
 /*
- * Tratamiento de llamada al sistema escribir. Llama simplemente a la
- * funcion de apoyo escribir_ker
- */
-int sis_escribir()
-{
-	char *texto;
-	unsigned int longi;
+Funcion auxiliar que amplia el slab de mutex con un bloque de MUT_POR_BLOQUE
+mutex, que pasan a la lista de libres. Devuelve -1 si no hay memoria
 
-	texto=(char *)leer_registro(1);
-	longi=(unsigned int)leer_registro(2);
+*/
+int ampliar_slab_mut(){
+
+	MUTptr bloque = malloc(MUT_POR_BLOQUE * sizeof(mutex));
+	if (bloque == NULL)
+		return -1;
+
+	for(int i=MUT_POR_BLOQUE-1; i>=0;i--){
+	
+		bloque[i].estado = LIBRE;
+		bloque[i].lista_mut_espera.primero = NULL;
+		bloque[i].lista_mut_espera.ultimo = NULL;
+		bloque[i].n_mut_espera = 0;
+		bloque[i].lista_lect_espera.primero = NULL;
+		bloque[i].lista_lect_espera.ultimo = NULL;
+		bloque[i].n_lect_espera = 0;
+		bloque[i].num_lectores = 0;
+		bloque[i].futex.palabra = 0;
+		bloque[i].futex.profundidad = 0;
+		bloque[i].siguiente = mut_libres;
+		mut_libres = &bloque[i];
+	
+	}
 
-	escribir_ker(texto, longi);
 	return 0;
 }
 
 /*
- * Tratamiento de llamada al sistema terminar_proceso. Llama a la
- * funcion auxiliar liberar_proceso
+Funcion auxiliar que inicializa la tabla de mutex: fija las cuotas con los
+parametros de arranque. Los mutex se reservan del slab segun se crean
+
+*/
+void iniciar_tabla_mut(){
+
+	max_mut = parametro_arranque("max_mutex", NUM_MUT);
+	max_desc_mut = parametro_arranque("max_desc_mutex", NUM_MUT_PROC);
+	lockstat_top = parametro_arranque("lockstat", LOCKSTAT_TOP);
+
+	zona_usuario.ticks = &ticks_sistema;
+
+}
+
+
+/*
+ *
+ * Funciones del registro (log) del nucleo
+ *	registrar formatear_registro volcar_log
+ *
+ * Los mensajes no se escriben al generarse: se guardan sin formatear en un
+ * anillo y se vuelcan en la consola fuera de los manejadores de
+ * interrupcion: con la UCP ociosa, al terminar cada llamada al sistema y
+ * antes de lo que escriba un proceso. Si el anillo se llena se descartan
+ * los mas antiguos.
  */
-int sis_terminar_proceso(){
 
-	for(int i = 0; p_proc_actual->n_descriptores_usados >= 1; i++){
-	
-		if(p_proc_actual -> conj_descriptores[i] != -1){
-			
-			if(cerrar_mutex(p_proc_actual -> conj_descriptores[i]) == -1){
-			
-				return 0;
-				
-			}
-			
+/*
+ * Guarda un mensaje si su nivel no supera el umbral. Copia los argumentos
+ * segun las conversiones del formato: los enteros tal cual y las cadenas
+ * dentro del registro (truncadas si no caben).
+ */
+void registrar(int nivel, const char *formato, ...){
+	registro_log *reg;
+	const char *p;
+	char *cad;
+	int n = 0, libre = 0;
+	va_list ap;
+
+	if (nivel > nivel_log)
+		return;
 
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
+	if (fin_log - ini_log == TAM_LOG) {
+		if (vol_log == ini_log) {
+			vol_log++;
+			log_perdidos++;
 		}
+		ini_log++;
 	}
-		
-		
-	printk("-> FIN PROCESO %d\n", p_proc_actual->id);
-
-	liberar_proceso();
+	reg = &anillo_log[fin_log % TAM_LOG];
+	reg->tick = ticks_sistema;
+	reg->nivel = nivel;
+	reg->formato = formato;
+	reg->cadenas = 0;
+
+	va_start(ap, formato);
+	for (p = formato; *p && n < MAX_ARGS_LOG; p++) {
+		if (*p != '%')
+			continue;
+		p++;
+		while (*p && strchr("-+ #0123456789.", *p))
+			p++;
+		if (*p == '%' || *p == '\0')
+			continue;
+		if (*p == 's') {
+			cad = va_arg(ap, char *);
+			reg->args[n] = libre;
+			reg->cadenas |= 1 << n;
+			while (libre < TAM_CADENAS_LOG - 1 && *cad)
+				reg->texto[libre++] = *cad++;
+			reg->texto[libre] = '\0';
+			if (libre < TAM_CADENAS_LOG - 1)
+				libre++;
+		}
+		else if (*p == 'l')
+			reg->args[n] = va_arg(ap, long);
+		else
+			reg->args[n] = va_arg(ap, int);
+		n++;
+	}
+	va_end(ap);
 
-        return 0; /* no deber�a llegar aqui */
+	fin_log++;
+	fijar_nivel_int(n_interrupcion);
 }
 
-
 /*
-Incluir la llamada que, entre otras labores, debe poner al proceso en estado
-bloqueado, reajustar las listas de BCPs correspondientes y realizar el cambio
-de contexto.
-*/
+ * Formatea un mensaje en buf (como mucho tam-1 caracteres). Devuelve su
+ * longitud.
+ */
+int formatear_registro(registro_log *reg, char *buf, int tam){
+	long a[MAX_ARGS_LOG];
+	int i, lon;
+
+	for (i = 0; i < MAX_ARGS_LOG; i++)
+		a[i] = (reg->cadenas & (1 << i)) ?
+			(long)(reg->texto + reg->args[i]) : reg->args[i];
+
+	/* tantos argumentos como MAX_ARGS_LOG */
+	lon = snprintf(buf, tam, reg->formato, a[0], a[1], a[2], a[3], a[4], a[5]);
+	return (lon < tam) ? lon : tam - 1;
+}
+
 /*
-int sis_cambios(BCPptr actual){
+ * Pasa a la consola los mensajes pendientes. Cada uno se saca del anillo
+ * con las interrupciones inhibidas, pero se formatea con el nivel del
+ * llamante, para no retrasarlas.
+ */
+void volcar_log(){
+	registro_log reg;
+	char linea[TAM_LINEA_LOG];
 
-	
-	//Cambio de contexto
-	p_proc_anterior=p_proc_actual;
-	p_proc_actual=planificador();
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
+	while (vol_log != fin_log) {
+		reg = anillo_log[vol_log % TAM_LOG];
+		vol_log++;
+		fijar_nivel_int(n_interrupcion);
+		encolar_consola(NULL, linea, formatear_registro(&reg, linea, sizeof(linea)));
+		fijar_nivel_int(NIVEL_3);
+	}
+	fijar_nivel_int(n_interrupcion);
+}
 
-	//cambio_contexto(NULL, &(p_proc_actual->contexto_regs));
-        //return 0; 
-        // no debería llegar aqui 
-	
-	printk("-> C.CONTEXTO POR FIN: de %d a %d\n",
-			p_proc_anterior->id, p_proc_actual->id);
+/*
+ *
+ * Funciones de la consola
+ *	separar_linea encolar_consola vaciar_consola vaciar_salida
+ *	pasar_linea escribir_consola
+ *
+ * Lo que escribe cada proceso se acumula en su linea en curso hasta el
+ * salto de linea, y las lineas completas de todos ellos, junto con los
+ * mensajes del nucleo, en un buffer comun que se escribe de una vez al
+ * llenarse, en la interrupcion software que pide cada tick y con la UCP
+ * ociosa. Asi las lineas de distintos procesos no se mezclan y muchas
+ * escrituras cortas cuestan una sola.
+ *
+ * Un proceso que se bloquea pasa antes su linea sin terminar, para que un
+ * indicador se vea mientras espera. Si despues escribe otro, se empieza
+ * linea nueva, y el resto de la del primero sale ya en la suya.
+ */
 
-	liberar_pila(p_proc_anterior->pila);
-	cambio_contexto(NULL, &(p_proc_actual->contexto_regs));
-        return 0; // no debería llegar aqui 
+/* Si lo ultimo encolado es la linea sin terminar de otro, la termina */
+void separar_linea(BCPptr proc){
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
+	if (linea_cortada != NULL && linea_cortada != proc)
+		encolar_consola(linea_cortada, "\n", 1);
+	fijar_nivel_int(n_interrupcion);
+}
 
-		
+/*
+ * Añade al buffer comun texto de una linea del proceso (NULL si es del
+ * nucleo), escribiendolo antes si no cabe
+ */
+void encolar_consola(BCPptr proc, char *texto, int lon){
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
+	separar_linea(proc);
+	if (lon > TAM_BUF_CONSOLA - lon_buf_consola)
+		vaciar_consola();
+	memcpy(buf_consola + lon_buf_consola, texto, lon);
+	lon_buf_consola += lon;
+	linea_cortada = (texto[lon - 1] == '\n') ? NULL : proc;
+	fijar_nivel_int(n_interrupcion);
+}
+
+/* Escribe en la consola el buffer comun */
+void vaciar_consola(){
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
+	if (lon_buf_consola > 0) {
+		escribir_ker(buf_consola, lon_buf_consola);
+		escrituras_consola++;
+		lon_buf_consola = 0;
+	}
+	fijar_nivel_int(n_interrupcion);
+}
 
+/*
+ * Escribe todo lo pendiente (la linea en curso del proceso actual, los
+ * mensajes del registro y el buffer comun) antes de un informe que se
+ * escribe directamente con printk.
+ */
+void vaciar_salida(){
+	pasar_linea(p_proc_actual);
+	volcar_log();
+	vaciar_consola();
 }
-*/
 
+/* Pasa al buffer comun la linea en curso del proceso, aunque no este completa */
+void pasar_linea(BCPptr proc){
+	if (proc->lon_linea_cons > 0) {
+		encolar_consola(proc, proc->linea_cons, proc->lon_linea_cons);
+		proc->lon_linea_cons = 0;
+	}
+}
 
-int obtener_id_pr(){
-	return p_proc_actual->id;
+/*
+ * Añade texto a la linea en curso del proceso, pasando al buffer comun
+ * cada linea que se completa (o que llena la del proceso).
+ */
+void escribir_consola(BCPptr proc, char *texto, unsigned int longi){
+	char *salto;
+	unsigned int n;
+
+	while (longi > 0) {
+		salto = memchr(texto, '\n', longi);
+		n = salto ? salto - texto + 1 : longi;
+		if (n > TAM_LINEA_CONSOLA - proc->lon_linea_cons)
+			n = TAM_LINEA_CONSOLA - proc->lon_linea_cons;
+		memcpy(proc->linea_cons + proc->lon_linea_cons, texto, n);
+		proc->lon_linea_cons += n;
+		texto += n;
+		longi -= n;
+		if (proc->lon_linea_cons == TAM_LINEA_CONSOLA ||
+				proc->linea_cons[proc->lon_linea_cons - 1] == '\n')
+			pasar_linea(proc);
+	}
 }
 
+/*
+ *
+ * Funciones relacionadas con el tratamiento de interrupciones
+ *	excepciones: exc_arit exc_mem
+ *	interrupciones de reloj: int_reloj
+ *	interrupciones del terminal: int_terminal
+ *	llamadas al sistemas: llam_sis
+ *	interrupciones SW: int_sw
+ *
+ * 
+ *  Añadir a la rutina de interrupción la detección de si se cumple el plazo de
+ *	algún proceso dormido. Si es así, debe cambiarle de estado y reajustar las
+ *	listas correspondientes
+ *
+ */
+
+/*
+ * Tratamiento de excepciones aritmeticas
+ */
+static void exc_arit(){
+
+	if (!viene_de_modo_usuario())
+		panico("excepcion aritmetica cuando estaba dentro del kernel");
+
 
+	registrar(LOG_AVISO, "-> EXCEPCION ARITMETICA EN PROC %d\n", p_proc_actual->id);
+	liberar_proceso();
 
+        return; /* no deber�a llegar aqui */
+}
 
-//proceso auxiliar para bloquear proceso y actualizar listas
+/*
+ * Tratamiento de excepciones en el acceso a memoria
+ */
+static void exc_mem(){
 
-void bloquear(){
+	if (!viene_de_modo_usuario())
+		panico("excepcion de memoria cuando estaba dentro del kernel");
 
-	
 
-	//poner el proceso en bloqueado
-	BCPptr actual = p_proc_actual;
+	registrar(LOG_AVISO, "-> EXCEPCION DE MEMORIA EN PROC %d\n", p_proc_actual->id);
+	liberar_proceso();
+
+        return; /* no deber�a llegar aqui */
+}
+
+/*
+ * Tratamiento de interrupciones de terminal
+ */
+static void int_terminal(){
+	BCPptr proc;
+	char car;
+
+	car = leer_puerto(DIR_TERMINAL);
+	registrar(LOG_DEPURACION, "-> TRATANDO INT. DE TERMINAL %c\n", car);
+
+	/* Disciplina de linea: la edicion se hace aqui, sin llamadas */
+	if (modo_terminal == TERM_CANONICO) {
+		if (car == '\r')
+			car = '\n';
+		if (car == CAR_BORRAR || car == CAR_SUPRIMIR) {
+			if (fin_term != fin_linea)
+				fin_term--;
+			return;
+		}
+		if (car == CAR_FIN_FICHERO) {
+			/* con la linea vacia es fin de fichero; si no, la entrega */
+			if (fin_term == fin_linea && !hay_eof) {
+				hay_eof = 1;
+				pos_eof = fin_term;
+			}
+			fin_linea = fin_term;
+			despertar_lector();
+			return;
+		}
+	}
+
+	/* En modo crudo, si hay lectores esperando va directamente al primero */
+	else if ((proc = lista_lectores.primero) != NULL) {
+		proc->car_terminal = (unsigned char)car;
+		despertar_lector();
+		return;
+	}
+
+	/* Si no se guarda en el buffer o, si esta lleno, se pierde (una linea
+	   que no cabe se entrega como este para que no bloquee al terminal) */
+	if (fin_term - ini_term == TAM_BUF_TERM) {
+		car_perdidos++;
+		if (fin_linea != fin_term) {
+			fin_linea = fin_term;
+			despertar_lector();
+		}
+		return;
+	}
+	buf_terminal[fin_term % TAM_BUF_TERM] = car;
+	fin_term++;
+
+	/* Se despierta al lector una vez por linea completa */
+	if (modo_terminal == TERM_CRUDO || car == '\n') {
+		fin_linea = fin_term;
+		despertar_lector();
+	}
+        return;
+}
+
+/* funcion auxiliar para la llamada dormir: vence el plazo del proceso dormido */
+static void despertar_dormido(void *arg){
+	BCPptr proc = (BCPptr)arg;
+
+	proc->estado = LISTO;
+	eliminar_elem(&lista_bloqueados, proc);
+	insertar_listo(proc);
+}
+
+
+/*
+ * Tratamiento de interrupciones de reloj
+ */
+static void int_reloj(){
+
+	/* Con la UCP ociosa cada interrupcion cubre varios ticks */
+	if (reloj_ocioso) {
+		ticks_sistema+=ticks_por_int;
+		recuperar_ticks();
+	}
+	else {
+		registrar(LOG_DEPURACION, "-> TRATANDO INT. DE RELOJ\n");
+		ticks_sistema++;
+
+		/* Contabiliza el tick; la expulsion se difiere a int_sw */
+		if (p_proc_actual && p_proc_actual->estado==LISTO)
+			contabilizar_tick(p_proc_actual);
+	}
+	avanzar_rueda();
+	if (p_proc_actual)
+		publicar_pagina(p_proc_actual);
+
+	/* La salida pendiente se escribe fuera de esta interrupcion */
+	if (lon_buf_consola > 0)
+		activar_int_SW();
+        return;
+}
+
+/*
+ * Tratamiento de llamadas al sistema
+ */
+static void tratar_llamsis(){
+	int nserv, res;
+
+	nserv=leer_registro(0);
+	if (nserv<NSERVICIOS)
+		res=(tabla_servicios[nserv].fservicio)();
+	else
+		res=-1;		/* servicio no existente */
+	escribir_registro(0,res);
+	publicar_pagina(p_proc_actual);	/* la llamada ha podido cambiar su estado */
+	volcar_log();
+	return;
+}
+
+/*
+ * Tratamiento de interrupciuones software: replanificacion diferida.
+ * Si el proceso a expulsar sigue en ejecucion y ha agotado su rodaja pasa
+ * al final de su nivel (o, si es de tiempo real y ha agotado su
+ * presupuesto, queda estrangulado); despues cede la UCP si hay otro mas
+ * prioritario.
+ */
+static void int_sw(){
+	BCPptr actual = p_proc_actual;
+	int n_interrupcion;
+
+	registrar(LOG_DEPURACION, "-> TRATANDO INT. SW\n");
+	vaciar_consola();
+
+	n_interrupcion = fijar_nivel_int(NIVEL_3);
+	if (actual == p_proc_expulsar && actual->estado == LISTO) {
+		p_proc_expulsar = NULL;
+		if (actual->clase == CLASE_TR && actual->estrangulado) {
+			eliminar_listo(actual);
+			actual->estado = ESTRANGULADO;
+			registrar(LOG_INFO, "-> PROC %d ESTRANGULADO HASTA SU PERIODO\n", actual->id);
+			p_proc_actual = planificador();
+			cambio_contexto(&(actual->contexto_regs), &(p_proc_actual->contexto_regs));
+		}
+		else {
+			if (actual->rodaja <= 0) {
+				eliminar_listo(actual);
+				insertar_listo(actual);
+			}
+			replanificar();
+		}
+	}
+	fijar_nivel_int(n_interrupcion);
+	return;
+}
+
+
+
+/*Añadir a la rutina de interrupción la detección de si se cumple el plazo de
+algún proceso dormido. Si es así, debe cambiarle de estado y reajustar las
+listas correspondientes*/
+
+
+
+
+
+
+
+
+
+
+
+/*
+ *
+ * Funcion auxiliar que crea un proceso reservando sus recursos.
+ * Usada por llamada crear_proceso.
+ *
+ */
+static int crear_tarea(char *prog, unsigned int tam_pila){
+	IMAGENptr imagen;
+	int error=0;
+	int clase;
+	BCP *p_proc;
+
+	if (tam_pila==0)
+		tam_pila=TAM_PILA;
+	clase=clase_pila(tam_pila);
+	if (clase<0)
+		return -1;	/* pila demasiado grande */
+
+	p_proc=buscar_BCP_libre();
+	if (p_proc==NULL)
+		return -1;	/* no hay entrada libre */
+
+	/* A rellenar el BCP ... */
+
+	/* obtiene la imagen de memoria, leyendo el ejecutable si no esta */
+	imagen=obtener_imagen(prog);
+	if (imagen)
+	{
+		p_proc->imagen=imagen;
+		p_proc->info_mem=imagen->info_mem;
+		p_proc->tam_pila=TAM_PILA_MIN<<clase;
+		p_proc->pila=reservar_pila(clase);
+		if (p_proc->pila==NULL) {
+			soltar_imagen(imagen);
+			liberar_BCP(p_proc);
+			return -1;	/* sin memoria para la pila */
+		}
+		fijar_contexto_ini(p_proc->info_mem, p_proc->pila, p_proc->tam_pila,
+			imagen->pc_inicial,
+			&(p_proc->contexto_regs));
+		p_proc->estado=LISTO;
+		p_proc->prioridad_base=(p_proc_actual) ?
+			p_proc_actual->prioridad_base : PRIORIDAD_DEFECTO;
+		p_proc->prioridad=p_proc->prioridad_base;
+		p_proc->elevado=0;
+		p_proc->mutex_esperado=NULL;
+		p_proc->rodaja=TICKS_POR_RODAJA;
+		p_proc->clase=(p_proc_actual) ?
+			p_proc_actual->clase : CLASE_PRIORIDAD;
+		p_proc->vruntime=vruntime_min;
+		p_proc->pos_monticulo=-1;
+		p_proc->lista=NULL;
+		p_proc->siguiente=p_proc->anterior=NULL;
+		if (p_proc->clase==CLASE_TR)	/* no hereda la reserva */
+			p_proc->clase=CLASE_PRIORIDAD;
+		p_proc->densidad=0;
+		p_proc->estrangulado=0;
+		iniciar_temporizador(&(p_proc->temp_periodo), nuevo_periodo, p_proc);
+		//para dormir
+		iniciar_temporizador(&(p_proc->temp_dormir), despertar_dormido, p_proc);
+		p_proc->car_terminal=-1;
+		p_proc->lon_linea_cons=0;
+		p_proc->consola_directa=0;
+		
+		//para mutex: inicializar los descriptores y por consecuencia el contador de descriptores usados
+		//(la tabla de descriptores de un BCP reutilizado se conserva)
+		for(int i=0; i < p_proc->tam_descriptores ; i++) {
+			p_proc->conj_descriptores[i] = NULL;
+			p_proc->lectura_desc[i] = 0;
+		}
+		p_proc->n_descriptores_usados = 0;
+		
+
+		/* lo inserta al final de cola de listos */
+		insertar_listo(p_proc);
+		error= 0;
+	}
+	else {
+		liberar_BCP(p_proc);
+		error= -1; /* fallo al crear imagen */
+	}
+
+	return error;
+}
+
+/*
+ *
+ * Rutinas que llevan a cabo las llamadas al sistema
+ *	sis_crear_proceso sis_escribir
+ *
+ */
+
+/*
+ * Tratamiento de llamada al sistema crear_proceso. Llama a la
+ * funcion auxiliar crear_tarea sis_terminar_proceso
+ */
+int sis_crear_proceso(){
+	char *prog;
+	unsigned int tam_pila;
+	int res;
+
+	registrar(LOG_INFO, "-> PROC %d: CREAR PROCESO\n", p_proc_actual->id);
+	prog=(char *)leer_registro(1);
+	tam_pila=(unsigned int)leer_registro(2);
+	res=crear_tarea(prog, tam_pila);
+	return res;
+}
+
+/*
+ * Tratamiento de llamada al sistema escribir. Agrupa el texto en la
+ * consola salvo que el proceso haya pedido salida directa, en cuyo caso lo
+ * escribe con escribir_ker tras lo que hubiera pendiente.
+ */
+int sis_escribir()
+{
+	char *texto;
+	unsigned int longi;
+
+	texto=(char *)leer_registro(1);
+	longi=(unsigned int)leer_registro(2);
+
+	volcar_log();		/* los mensajes previos salen antes */
+	llamadas_escribir++;
+	if (p_proc_actual->consola_directa) {
+		separar_linea(p_proc_actual);
+		vaciar_consola();
+		escribir_ker(texto, longi);
+		escrituras_consola++;
+	}
+	else
+		escribir_consola(p_proc_actual, texto, longi);
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema terminar_proceso. Llama a la
+ * funcion auxiliar liberar_proceso
+ */
+int sis_terminar_proceso(){
+
+	registrar(LOG_INFO, "-> FIN PROCESO %d\n", p_proc_actual->id);
+
+	liberar_proceso();
+
+        return 0; /* no deber�a llegar aqui */
+}
+
+
+/*
+Incluir la llamada que, entre otras labores, debe poner al proceso en estado
+bloqueado, reajustar las listas de BCPs correspondientes y realizar el cambio
+de contexto.
+*/
+/*
+int sis_cambios(BCPptr actual){
+
+	
+	//Cambio de contexto
+	p_proc_anterior=p_proc_actual;
+	p_proc_actual=planificador();
+
+	//cambio_contexto(NULL, &(p_proc_actual->contexto_regs));
+        //return 0; 
+        // no debería llegar aqui 
+	
+	printk("-> C.CONTEXTO POR FIN: de %d a %d\n",
+			p_proc_anterior->id, p_proc_actual->id);
+
+	liberar_pila(p_proc_anterior->pila);
+	cambio_contexto(NULL, &(p_proc_actual->contexto_regs));
+        return 0; // no debería llegar aqui 
+
+		
+
+}
+*/
+
+
+int obtener_id_pr(){
+	return p_proc_actual->id;
+}
+
+
+
+
+//proceso auxiliar para bloquear proceso y actualizar listas: pasa el
+//proceso actual de listos a la lista de espera indicada
+
+void bloquear(lista_BCPs *lista){
+
+	
+
+	//poner el proceso en bloqueado
+	BCPptr actual = p_proc_actual;
+
+	//lo que haya escrito sin salto (un indicador) se ve mientras espera
+	pasar_linea(actual);
+	 
+	actual->estado = BLOQUEADO;
+
+
+	//reajustar listas de BCPs
+	//	1º: eliminar de listos
+	eliminar_listo(p_proc_actual);
+
+	//	2º: añadir a la lista de espera
+	insertar_ultimo(lista,p_proc_actual);
+
+
+	p_proc_actual = planificador();
+
+	
+
+	//Como actual es un puntero del BCP debemos seguir rabajando con puntores en el cambio de contecto
+	//p_proc_actual sera el proceso que se va a derpertar y actual sera el que se va a bloquear y queremos dormir
+	cambio_contexto(&(actual->contexto_regs),&(p_proc_actual->contexto_regs));
+
+}
+
+/*
+ * Tratamiento de llamada al sistema fijar_prioridad. Cambia la prioridad
+ * base del proceso actual, que pasa al final de su nuevo nivel, y devuelve
+ * la anterior o -1 si la prioridad no es valida. Mientras posea un mutex
+ * con procesos mas prioritarios esperando conserva la que ha heredado.
+ */
+int fijar_prioridad(unsigned int prioridad){
+	int anterior = p_proc_actual->prioridad_base;
+
+	prioridad = (unsigned int)leer_registro(1);
+	if (prioridad >= NUM_PRIORIDADES)
+		return -1;
+
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
+
+	eliminar_listo(p_proc_actual);
+	p_proc_actual->prioridad_base = prioridad;
+	recalcular_prioridad(p_proc_actual);
+	insertar_listo(p_proc_actual);
+	replanificar();
+
+	fijar_nivel_int(n_interrupcion);
+	return anterior;
+}
+
+/*
+ * Tratamiento de llamada al sistema fijar_clase. Pasa el proceso actual a
+ * CLASE_PRIORIDAD o CLASE_JUSTA y devuelve la clase anterior o -1 si la
+ * clase no es valida. Al entrar en CLASE_JUSTA parte del tiempo virtual
+ * minimo para no acaparar la UCP.
+ */
+int fijar_clase(unsigned int clase){
+	int anterior = p_proc_actual->clase;
+
+	clase = (unsigned int)leer_registro(1);
+	if (clase != CLASE_PRIORIDAD && clase != CLASE_JUSTA)
+		return -1;
+
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
+
+	eliminar_listo(p_proc_actual);
+	if (anterior == CLASE_TR)
+		salir_tiempo_real(p_proc_actual);
+	if (clase == CLASE_JUSTA && anterior != CLASE_JUSTA)
+		p_proc_actual->vruntime = vruntime_min;
+	p_proc_actual->clase = clase;
+	insertar_listo(p_proc_actual);
+	replanificar();
+
+	fijar_nivel_int(n_interrupcion);
+	return anterior;
+}
+
+/*
+ * Tratamiento de llamada al sistema fijar_tiempo_real. Pasa el proceso
+ * actual a CLASE_TR con el periodo, presupuesto y plazo relativo (en ticks)
+ * indicados; un plazo 0 equivale al periodo y un periodo 0 lo devuelve a
+ * CLASE_PRIORIDAD. Rechaza (-1) la peticion si los parametros no son
+ * coherentes o si la utilizacion total superaria UTILIZACION_MAX_TR.
+ */
+int fijar_tiempo_real(unsigned int periodo, unsigned int presupuesto,
+		unsigned int plazo){
+	int densidad = 0, disponible;
+
+	periodo = (unsigned int)leer_registro(1);
+	presupuesto = (unsigned int)leer_registro(2);
+	plazo = (unsigned int)leer_registro(3);
+	if (plazo == 0)
+		plazo = periodo;
+	if (periodo != 0 && (presupuesto == 0 || presupuesto > plazo ||
+			plazo > periodo))
+		return -1;
+
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
+
+	if (periodo != 0) {
+		/* control de admision por densidad: sum(C/D) <= U max; el
+		   producto se hace en 64 bits para que no desborde */
+		densidad = (int)(((unsigned long long)presupuesto * 1000 +
+			plazo - 1) / plazo);
+		disponible = UTILIZACION_MAX_TR - utilizacion_tr;
+		if (p_proc_actual->clase == CLASE_TR)
+			disponible += p_proc_actual->densidad;
+		if (densidad > disponible) {
+			registrar(LOG_AVISO, "-> PROC %d: TIEMPO REAL RECHAZADO (%d/%d)\n",
+				p_proc_actual->id, densidad, disponible);
+			fijar_nivel_int(n_interrupcion);
+			return -1;
+		}
+	}
+
+	eliminar_listo(p_proc_actual);
+	if (p_proc_actual->clase == CLASE_TR)
+		salir_tiempo_real(p_proc_actual);
+	if (periodo != 0)
+		entrar_tiempo_real(p_proc_actual, periodo, presupuesto, plazo,
+			densidad);
+	insertar_listo(p_proc_actual);
+	replanificar();
+
+	fijar_nivel_int(n_interrupcion);
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema esperar_periodo. Un proceso de tiempo
+ * real que ha terminado el trabajo de este periodo cede la UCP hasta el
+ * comienzo del siguiente.
+ */
+int esperar_periodo(){
+	BCPptr actual = p_proc_actual;
+
+	if (actual->clase != CLASE_TR)
+		return -1;
+
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
+
+	pasar_linea(actual);
+	eliminar_listo(actual);
+	actual->estado = ESTRANGULADO;
+	p_proc_actual = planificador();
+	cambio_contexto(&(actual->contexto_regs), &(p_proc_actual->contexto_regs));
+
+	fijar_nivel_int(n_interrupcion);
+	return 0;
+}
+
+/*	FUNCION DORMIR 		*/
+int dormir(unsigned int segundos){
+
+	//dormir llama a bloquear
+	//	-bloquear lo bloquea 
+	//	-actualiza tablas
+	//	-cambia contexto
+	//cuando pasa el tiempo   ****HAY 
+	//
+
+	//El valor pasado a la funcion se guarda en el registro 1 y utilizamos "leer_registro" para leer ese registro
+	unsigned int segundos_espera = (unsigned int)leer_registro(1);
+	
+	
+	if (segundos_espera == 0)
+		return 0;
+
+	//guardamos el nivel de interrupcion
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
+
+	//Se multiplican los segundos por los ticks establecidos (en este caso 100)
+	//y se arma el plazo en la rueda de temporizadores
+	armar_temporizador(&(p_proc_actual->temp_dormir),
+		ticks_sistema + (unsigned long)segundos_espera * TICK);
+
+	//poner el proceso en bloqueado
+	bloquear(&lista_bloqueados);
+
+
+
+
+	//cuando pasa el tiempo
+
+	//vuelve 
+
+	//Restauramos el nivel de interrupcion
+	fijar_nivel_int(n_interrupcion);
+	return 0;
+
+}
+
+/*
+ * Tratamiento de llamada al sistema enviar_anillo. Ejecuta en orden las
+ * peticiones pendientes del anillo del proceso como si las hubiera hecho
+ * una a una: copia sus argumentos a los registros e invoca el servicio, que
+ * puede bloquear al proceso. Cada resultado se deja en la cola de
+ * respuestas; se para si esta llena. No admite terminar_proceso ni otro
+ * enviar_anillo (respuesta -1). Devuelve cuantas peticiones ha consumido.
+ */
+int enviar_anillo(anillo_llamsis *anillo){
+	peticion_llamsis pet;
+	respuesta_llamsis *resp;
+	int i, hechas = 0;
+
+	anillo = (anillo_llamsis *)leer_registro(1);
+
+	while (anillo->ini_pet != anillo->fin_pet &&
+			anillo->fin_resp - anillo->ini_resp < TAM_ANILLO) {
+
+		pet = anillo->pet[anillo->ini_pet % TAM_ANILLO];
+		anillo->ini_pet++;
+
+		resp = &(anillo->resp[anillo->fin_resp % TAM_ANILLO]);
+		resp->dato = pet.dato;
+		if (pet.llamada < 0 || pet.llamada >= NSERVICIOS ||
+				pet.llamada == TERMINAR_PROCESO ||
+				pet.llamada == ENVIAR_ANILLO)
+			resp->resultado = -1;
+		else {
+			for (i = 0; i < MAX_ARGS_ANILLO; i++)
+				escribir_registro(i + 1, pet.args[i]);
+			resp->resultado = (tabla_servicios[pet.llamada].fservicio)();
+		}
+		anillo->fin_resp++;
+		hechas++;
+	}
+	return hechas;
+}
+
+/*
+ * Funciones auxiliares del terminal
+ *	despertar_lector leer_terminal
+ */
+
+/* Desbloquea al primer proceso que espera datos del terminal, si lo hay */
+void despertar_lector(){
+	BCPptr proc = lista_lectores.primero;
+
+	if (proc == NULL)
+		return;
+	proc->estado = LISTO;
+	eliminar_elem(&lista_lectores, proc);
+	insertar_listo(proc);
+}
+
+/*
+ * Copia en buf hasta n caracteres del terminal, bloqueando mientras no haya
+ * ninguno que leer: en modo crudo cualquiera que haya llegado y en modo
+ * canonico solo lineas completas, sin pasar del final de la primera. En
+ * modo crudo int_terminal entrega el caracter directamente al lector que
+ * despierta; como el buffer solo se llena cuando no hay lectores esperando,
+ * se respeta el orden de llegada de caracteres y lectores. Devuelve cuantos
+ * ha copiado o 0 si recoge un fin de fichero.
+ */
+int leer_terminal(char *buf, unsigned int n){
+	unsigned int i = 0, limite;
+	char car;
+
+	if (n == 0)
+		return 0;
+
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
+	while (ini_term == fin_linea && !hay_eof) {
+		/* antes de esperar se muestra lo escrito sin salto (un indicador) */
+		pasar_linea(p_proc_actual);
+		vaciar_consola();
+		bloquear(&lista_lectores);
+		if (p_proc_actual->car_terminal >= 0) {
+			buf[i++] = (char)p_proc_actual->car_terminal;
+			p_proc_actual->car_terminal = -1;
+			break;
+		}
+	}
+
+	if (i == 0 && hay_eof && ini_term == pos_eof)
+		hay_eof = 0;
+	else {
+		limite = hay_eof ? pos_eof : fin_linea;
+		while (i < n && ini_term != limite) {
+			car = buf_terminal[ini_term % TAM_BUF_TERM];
+			ini_term++;
+			buf[i++] = car;
+			if (modo_terminal == TERM_CANONICO && car == '\n')
+				break;
+		}
+	}
+
+	/* Si quedan datos, le toca al siguiente lector */
+	if (ini_term != fin_linea || hay_eof)
+		despertar_lector();
+	fijar_nivel_int(n_interrupcion);
+	return i;
+}
+
+/*
+ * Tratamiento de llamada al sistema leer_caracter. Devuelve el siguiente
+ * caracter del terminal, bloqueando hasta que llegue si no hay ninguno, o
+ * -1 si en modo canonico se encuentra un fin de fichero.
+ */
+int leer_caracter(){
+	char car;
+
+	if (leer_terminal(&car, 1) == 0)
+		return -1;
+	return (unsigned char)car;
+}
+
+/*
+ * Tratamiento de llamada al sistema leer. Lee del terminal hasta n
+ * caracteres con una sola llamada (en modo canonico, como mucho una
+ * linea). Devuelve cuantos ha leido, 0 si es fin de fichero.
+ */
+int leer(char *buf, unsigned int n){
+	buf = (char *)leer_registro(1);
+	n = (unsigned int)leer_registro(2);
+
+	return leer_terminal(buf, n);
+}
+
+/*
+ * Tratamiento de llamada al sistema leer_log. Copia en buf, del mas antiguo
+ * al mas reciente, los mensajes que conserva el registro (tambien los ya
+ * volcados) precedidos de su nivel y su tick, mientras quepan enteros.
+ * Termina la cadena con un nulo y devuelve su longitud.
+ */
+int leer_log(char *buf, unsigned int tam){
+	registro_log reg;
+	char linea[TAM_LINEA_LOG];
+	unsigned long i;
+	unsigned int total = 0;
+	int lon;
+
+	buf = (char *)leer_registro(1);
+	tam = (unsigned int)leer_registro(2);
+	if (tam == 0)
+		return 0;
+
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
+	for (i = ini_log; i < fin_log; i++) {
+		if (i < ini_log)	/* descartado mientras se copiaba */
+			i = ini_log;
+		reg = anillo_log[i % TAM_LOG];
+		fijar_nivel_int(n_interrupcion);
+
+		lon = snprintf(linea, sizeof(linea), "<%d>[%6lu] ", reg.nivel, reg.tick);
+		lon += formatear_registro(&reg, linea + lon, sizeof(linea) - lon);
+		if (total + lon >= tam) {
+			fijar_nivel_int(NIVEL_3);
+			break;
+		}
+		memcpy(buf + total, linea, lon);
+		total += lon;
+		fijar_nivel_int(NIVEL_3);
+	}
+	fijar_nivel_int(n_interrupcion);
+	buf[total] = '\0';
+	return total;
+}
+
+/*
+ * Tratamiento de llamada al sistema fijar_nivel_log. Cambia el umbral de
+ * los mensajes que se registran: con LOG_DEPURACION se incluyen los de
+ * cada tick, cambio de contexto y operacion sobre mutex. Devuelve el
+ * umbral anterior o -1 si el nivel no es valido.
+ */
+int fijar_nivel_log(int nivel){
+	int anterior = nivel_log;
+
+	nivel = (int)leer_registro(1);
+	if (nivel < LOG_ERROR || nivel > LOG_DEPURACION)
+		return -1;
+	nivel_log = nivel;
+	return anterior;
+}
+
+/*
+ * Tratamiento de llamada al sistema fijar_consola. Con CONSOLA_DIRECTA lo
+ * que escribe el proceso sale en cada llamada, sin agrupar; con
+ * CONSOLA_LINEAS se agrupa por lineas. Devuelve el modo anterior o -1 si
+ * el modo no es valido.
+ */
+int fijar_consola(int modo){
+	int anterior = p_proc_actual->consola_directa ?
+		CONSOLA_DIRECTA : CONSOLA_LINEAS;
+
+	modo = (int)leer_registro(1);
+	if (modo != CONSOLA_LINEAS && modo != CONSOLA_DIRECTA)
+		return -1;
+
+	/* lo ya escrito sale antes que lo que escriba directamente */
+	if (modo == CONSOLA_DIRECTA) {
+		pasar_linea(p_proc_actual);
+		vaciar_consola();
+	}
+	p_proc_actual->consola_directa = (modo == CONSOLA_DIRECTA);
+	return anterior;
+}
+
+/*
+ * Tratamiento de llamada al sistema fijar_modo_terminal. Con TERM_CANONICO
+ * solo se entregan lineas completas, editadas al llegar los caracteres;
+ * con TERM_CRUDO cada caracter segun llega. Lo que haya en el buffer al
+ * cambiar de modo queda disponible. Devuelve el modo anterior o -1 si el
+ * modo no es valido.
+ */
+int fijar_modo_terminal(int modo){
+	int anterior = modo_terminal;
+
+	modo = (int)leer_registro(1);
+	if (modo != TERM_CRUDO && modo != TERM_CANONICO)
+		return -1;
+
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
+	modo_terminal = modo;
+	if (fin_linea != fin_term) {
+		fin_linea = fin_term;
+		despertar_lector();
+	}
+	fijar_nivel_int(n_interrupcion);
+	return anterior;
+}
+
+/*        SERVICIOS MUTEX        */
+
+
+
+/*Crear mutex:
+	-Crea el mutex con el nombre y tipo especificados. 
+	-Devuelve un entero que representa un descriptor para acceder al mutex. 
+	-En caso de error devuelve un número negativo. 
+	-Habrá que definir dos constantes, que deberían incluirse tanto en el archivo de cabecera usado por los programas 
+	de usuario (“servicios.h”) como en el usado por el sistema operativo 
+	(“kernel.h”), para facilitar la especificación del tipo de mutex 
+	(NO_RECURSIVO y RECURSIVO) */
+
+
+
+
+/*
+ * Funciones auxiliares de mutex
+ *	buscar_mut_nombre buscar_hueco_descriptores mutex_de_descriptor
+ *	soltar_mutex eliminar_mutex cerrar_descriptor cerrar_descriptores_mutex
+ *
+ * Los nombres se resuelven con una tabla hash y cada descriptor de un
+ * proceso apunta directamente a su mutex, de modo que abrir, lock y unlock
+ * no dependen del numero de mutex que haya en el sistema.
+ */
+
+//funcion auxiliar a mutex: "buscar mutex por nombre", devuelve el mutex con ese nombre o NULL
+MUTptr buscar_mut_nombre(char *nombre){
+	MUTptr mut;
+
+	for (mut = tabla_hash_mut[hash_cadena(nombre) & (TAM_HASH_MUT-1)];
+			mut != NULL; mut = mut->siguiente)
+		if (strcmp(mut->nombre, nombre) == 0)
+			return mut;
+	return NULL; //Error: nombre no encontrado
+}
+
+	//funcion auxiliar a mutex: busca un hueco en el array de descriptores,
+	//duplicandolo si esta lleno y no se ha alcanzado la cuota del proceso
+int buscar_hueco_descriptores() {
+    BCPptr proc = p_proc_actual;
+    int i = 0;
+
+    if (proc->n_descriptores_usados < proc->tam_descriptores) {
+        while (proc->conj_descriptores[i] != NULL) //hay hueco seguro
+            i++;
+        return i; //devuelve el indice del hueco buscado
+    }
+
+    if (proc->tam_descriptores >= max_desc_mut)
+        return -1; //Error: no se encuentra hueco de descriptor
+
+    int nuevo_tam = proc->tam_descriptores ? 2 * proc->tam_descriptores : 1;
+    if (nuevo_tam > max_desc_mut)
+        nuevo_tam = max_desc_mut;
+
+    MUTptr *nueva = realloc(proc->conj_descriptores, nuevo_tam * sizeof(MUTptr));
+    if (nueva == NULL)
+        return -1; //Error: sin memoria para ampliar la tabla
+    proc->conj_descriptores = nueva; //aun con el tamaño anterior en uso
+
+    char *lecturas = realloc(proc->lectura_desc, nuevo_tam);
+    if (lecturas == NULL)
+        return -1;
+    proc->lectura_desc = lecturas;
+
+    for (i = proc->tam_descriptores; i < nuevo_tam; i++) {
+        nueva[i] = NULL;
+        lecturas[i] = 0;
+    }
+    i = proc->tam_descriptores; //primer hueco: el primero de los nuevos
+    proc->tam_descriptores = nuevo_tam;
+    publicar_zona_futex(proc); //la tabla ha podido cambiar de sitio
+    return i;
+}
+
+//devuelve el mutex asociado a un descriptor del proceso actual o NULL si no es valido
+MUTptr mutex_de_descriptor(unsigned int desc){
+	if (desc >= p_proc_actual->tam_descriptores)
+		return NULL;
+	return p_proc_actual->conj_descriptores[desc];
+}
+
+//como mutex_de_descriptor, pero exige que el objeto sea de la primitiva indicada
+MUTptr objeto_de_descriptor(unsigned int desc, int primitiva){
+	MUTptr mut = mutex_de_descriptor(desc);
+
+	if (mut == NULL || mut->primitiva != primitiva)
+		return NULL;
+	return mut;
+}
+
+//identificador del poseedor de un mutex segun su palabra de cerrojo (-1 si esta libre)
+int poseedor_mut(MUTptr mut){
+	unsigned int palabra = mut->futex.palabra & ~FUTEX_ESPERANDO;
+
+	return palabra ? (int)(palabra - 1) : -1;
+}
+
+//actualiza la pagina de datos del nucleo con el reloj y el proceso en ejecucion;
+//la secuencia impar durante la escritura avisa a libserv de que repita la lectura
+void publicar_pagina(BCPptr proc){
+	pagina_nucleo.secuencia++;
+	__sync_synchronize();
+	pagina_nucleo.ticks = ticks_sistema;
+	pagina_nucleo.id = proc->id;
+	pagina_nucleo.prioridad = proc->prioridad;
+	pagina_nucleo.clase = proc->clase;
+	pagina_nucleo.rodaja = proc->rodaja;
+	pagina_nucleo.procs_vivos = num_procs_vivos;
+	__sync_synchronize();
+	pagina_nucleo.secuencia++;
+}
+
+//publica a libserv el proceso que pasa a ejecutar y su tabla de descriptores;
+//como la palabra de cerrojo es el primer campo del mutex, la tabla de MUTptr
+//sirve tal cual como tabla de punteros a palabra_futex
+void publicar_zona_futex(BCPptr proc){
+	zona_usuario.id = proc->id;
+	zona_usuario.descriptores = (palabra_futex **) proc->conj_descriptores;
+	zona_usuario.tam_descriptores = proc->tam_descriptores;
+}
+
+/*
+ * Herencia de prioridad: el poseedor de un mutex ejecuta con la prioridad
+ * del mas prioritario de los procesos que lo esperan, de forma transitiva
+ * si a su vez espera otro mutex, y la recupera al soltarlo. Solo afecta a
+ * la clase por prioridades; en las demas el campo no se usa para planificar.
+ */
+
+//cambia la prioridad efectiva de un proceso, recolocandolo en listos y contabilizando la elevacion
+void fijar_prioridad_efectiva(BCPptr proc, int prioridad){
+	int elevado = prioridad < proc->prioridad_base;
+
+	if (elevado && !proc->elevado) {
+		num_elevaciones++;
+		proc->inicio_elevacion = ticks_sistema;
+	}
+	else if (!elevado && proc->elevado)
+		ticks_elevados += ticks_sistema - proc->inicio_elevacion;
+	proc->elevado = elevado;
+
+	if (prioridad == proc->prioridad)
+		return;
+
+	if (proc->estado == LISTO && proc->clase == CLASE_PRIORIDAD && proc->lista != NULL) {
+		eliminar_listo(proc);
+		proc->prioridad = prioridad;
+		insertar_listo(proc);
+		//si baja el que ejecuta, puede haber otro mas prioritario
+		if (proc == p_proc_actual)
+			pedir_replanificacion();
+	}
+	else
+		proc->prioridad = prioridad;
+}
+
+//propaga la prioridad de un proceso que espera el mutex a su poseedor y, si este
+//tambien espera, al poseedor del siguiente mutex de la cadena
+void heredar_prioridad(MUTptr mut, int prioridad){
+	int saltos = 0;
+
+	while (mut != NULL && saltos++ < num_procs_vivos) {
+
+		BCPptr poseedor = buscar_BCP(poseedor_mut(mut));
+		if (poseedor == NULL || poseedor->prioridad <= prioridad)
+			break;
+
+		registrar(LOG_DEPURACION, "Proceso %d hereda la prioridad %d por el mutex %s\n",
+			poseedor->id, prioridad, mut->nombre);
+		fijar_prioridad_efectiva(poseedor, prioridad);
+		mut = poseedor->mutex_esperado;
+
+	}
+}
+
+//recalcula la prioridad de un proceso: su base o la del mas prioritario que espera alguno de sus mutex
+void recalcular_prioridad(BCPptr proc){
+	int prioridad = proc->prioridad_base;
+	BCPptr p;
+
+	for (int i = 0; i < proc->tam_descriptores; i++) {
+		MUTptr mut = proc->conj_descriptores[i];
+		if (mut == NULL || poseedor_mut(mut) != proc->id)
+			continue;
+		for (p = mut->lista_mut_espera.primero; p != NULL; p = p->siguiente)
+			if (p->prioridad < prioridad)
+				prioridad = p->prioridad;
+		//lectores que esperan a que suelte un rwlock en escritura
+		for (p = mut->lista_lect_espera.primero; p != NULL; p = p->siguiente)
+			if (p->prioridad < prioridad)
+				prioridad = p->prioridad;
+	}
+
+	fijar_prioridad_efectiva(proc, prioridad);
+}
+
+//cede un mutex (o un rwlock en escritura) al primero de los que lo esperan
+//(orden FIFO) y lo pasa a listo
+void ceder_mutex(MUTptr mut){
+
+	mut->n_mut_espera--;
+	BCPptr p_proc_bloqueando = mut->lista_mut_espera.primero;
+	eliminar_primero(&(mut->lista_mut_espera));
+
+	//la palabra pasa al nuevo poseedor, marcada si quedan esperando (un rwlock siempre)
+	mut->futex.palabra = FUTEX_POSEEDOR(p_proc_bloqueando->id) |
+		(mut->n_mut_espera || mut->primitiva == PRIM_RW ? FUTEX_ESPERANDO : 0);
+	mut->futex.profundidad = 1;
+	p_proc_bloqueando->mutex_esperado = NULL;
+	anotar_adquisicion(mut, p_proc_bloqueando, 1);
+
+	p_proc_bloqueando->estado = LISTO;
+	insertar_listo(p_proc_bloqueando);
+
+	//hereda de los que siguen esperando
+	recalcular_prioridad(p_proc_bloqueando);
+	registrar(LOG_DEPURACION, "El %s %s pasa al proceso %d\n",mut->primitiva == PRIM_RW ? "rwlock" : "mutex",
+		mut->nombre,p_proc_bloqueando->id);
+}
+
+//comprueba si bloquear al proceso actual en mut cerraria un ciclo en el grafo
+//de espera, cuyas aristas son mutex_esperado (proceso -> mutex) y la palabra
+//de cerrojo (mutex -> poseedor) y se mantienen en cada bloqueo y cesion. Se
+//recorre la cadena de poseedores, asi que el coste es su longitud. Si hay
+//ciclo lo vuelca por el log del nucleo
+int detectar_interbloqueo(MUTptr mut){
+	MUTptr m = mut;
+	BCPptr poseedor, esperando;
+	int saltos = 0;
+
+	while ((poseedor = buscar_BCP(poseedor_mut(m))) != p_proc_actual) {
+		if (poseedor == NULL || poseedor->mutex_esperado == NULL ||
+				saltos++ >= num_procs_vivos)
+			return 0;
+		m = poseedor->mutex_esperado;
+	}
+
+	registrar(LOG_AVISO, "INTERBLOQUEO: el proceso %d cerraria el ciclo:\n", p_proc_actual->id);
+	for (esperando = p_proc_actual, m = mut; ; m = esperando->mutex_esperado) {
+		poseedor = buscar_BCP(poseedor_mut(m));
+		registrar(LOG_AVISO, "  %d espera %s, poseido por %d\n", esperando->id, m->nombre, poseedor->id);
+		if (poseedor == p_proc_actual)
+			break;
+		esperando = poseedor;
+	}
+	return 1;
+}
+
+/*
+ * Estadisticas de contienda (lockstat). Se guardan en un registro por
+ * nombre y primitiva al que apunta la palabra de cerrojo del objeto, asi
+ * que libserv tambien las actualiza en el camino rapido
+ */
+
+//registro de estadisticas de un nombre, que se crea la primera vez que se usa
+estad_futex *buscar_estad_mut(char *nombre, int primitiva){
+	ESTADptr *entrada = &tabla_estad_mut[hash_cadena(nombre) & (TAM_HASH_MUT-1)];
+	ESTADptr e;
+
+	for (e = *entrada; e != NULL; e = e->siguiente)
+		if (e->primitiva == primitiva && strcmp(e->nombre, nombre) == 0)
+			return &(e->datos);
+
+	e = calloc(1, sizeof(estad_mut));
+	if (e == NULL)
+		return &(estad_descartadas.datos);
+	strcpy(e->nombre, nombre);
+	e->primitiva = primitiva;
+	e->siguiente = *entrada;
+	*entrada = e;
+	return &(e->datos);
+}
+
+//proc obtiene el objeto; si ha tenido que esperar se anota cuanto
+void anotar_adquisicion(MUTptr mut, BCPptr proc, int contendida){
+	estad_futex *e = mut->futex.estad;
+
+	e->adquisiciones++;
+	if (contendida) {
+		unsigned long espera = ticks_sistema - proc->inicio_espera;
+		e->contendidas++;
+		e->espera_total += espera;
+		if (espera > e->espera_max)
+			e->espera_max = espera;
+	}
+	mut->futex.inicio = ticks_sistema;
+	anotar_profundidad(mut);
+}
+
+void anotar_profundidad(MUTptr mut){
+	if (mut->futex.profundidad > mut->futex.estad->profundidad_max)
+		mut->futex.estad->profundidad_max = mut->futex.profundidad;
+}
+
+//el poseedor suelta el objeto del todo
+void anotar_liberacion(MUTptr mut){
+	mut->futex.estad->posesion_total += ticks_sistema - mut->futex.inicio;
+}
+
+static int comparar_estad(const void *a, const void *b){
+	const estad_futex *ea = &((*(ESTADptr *)a)->datos);
+	const estad_futex *eb = &((*(ESTADptr *)b)->datos);
+
+	if (ea->espera_total != eb->espera_total)
+		return ea->espera_total < eb->espera_total ? 1 : -1;
+	if (ea->contendidas != eb->contendidas)
+		return ea->contendidas < eb->contendidas ? 1 : -1;
+	return ea->adquisiciones < eb->adquisiciones ? 1 :
+		ea->adquisiciones > eb->adquisiciones ? -1 : 0;
+}
+
+//vuelca las estadisticas de los n objetos con mas ticks de espera (todos si n es 0)
+void informe_lockstat(int n){
+	ESTADptr e, *v;
+	int i, num = 0;
+
+	for (i = 0; i < TAM_HASH_MUT; i++)
+		for (e = tabla_estad_mut[i]; e != NULL; e = e->siguiente)
+			num++;
+	if (num == 0 || (v = malloc(num * sizeof(ESTADptr))) == NULL)
+		return;
+
+	num = 0;
+	for (i = 0; i < TAM_HASH_MUT; i++)
+		for (e = tabla_estad_mut[i]; e != NULL; e = e->siguiente)
+			v[num++] = e;
+	qsort(v, num, sizeof(ESTADptr), comparar_estad);
+
+	if (n == 0 || n > num)
+		n = num;
+	printk("-> LOCKSTAT: %d DE %d OBJETOS POR TICKS DE ESPERA\n", n, num);
+	printk("   %-8s %-9s %8s %8s %8s %6s %8s %4s\n", "NOMBRE", "TIPO",
+		"ADQ", "CONTEND", "ESPERA", "MAX", "POSESION", "PROF");
+	for (i = 0; i < n; i++)
+		printk("   %-8s %-9s %8lu %8lu %8lu %6lu %8lu %4d\n", v[i]->nombre,
+			nombre_primitiva[v[i]->primitiva],
+			v[i]->datos.adquisiciones, v[i]->datos.contendidas,
+			v[i]->datos.espera_total, v[i]->datos.espera_max,
+			v[i]->datos.posesion_total, v[i]->datos.profundidad_max);
+	if (estad_descartadas.datos.adquisiciones)
+		printk("   (%lu adquisiciones sin registro por falta de memoria)\n",
+			estad_descartadas.datos.adquisiciones);
+	free(v);
+}
+
+//libera del todo un mutex: si hay procesos esperando, se lo cede directamente
+//al primero; si no, queda sin poseedor
+void soltar_mutex(MUTptr mut){
+
+	anotar_liberacion(mut);
+
+	if(mut->n_mut_espera >= 1){
+
+		ceder_mutex(mut);
+
+	}
+	else {
+
+		mut->futex.palabra = 0;
+		mut->futex.profundidad = 0;
+		registrar(LOG_DEPURACION, "El mutex %s ha sido desbloqueado\n",mut->nombre);
+
+	}
+}
+
+//despierta al primer proceso que esperaba para crear un mutex
+void despertar_creador(){
+
+	if(lista_esperando_mut.primero != NULL) { //hay procesos esperando para crear un mutex
+
+		BCPptr p_proc_bloqueando = lista_esperando_mut.primero;
+		eliminar_primero(&lista_esperando_mut);
+		p_proc_bloqueando->estado = LISTO;
+		insertar_listo(p_proc_bloqueando);
+
+	}
+}
+
+//elimina un mutex sin descriptores abiertos y despierta al primer proceso que esperaba para crear uno
+void eliminar_mutex(MUTptr mut){
+	MUTptr *p;
+
+	for (p = &tabla_hash_mut[hash_cadena(mut->nombre) & (TAM_HASH_MUT-1)];
+			*p != mut; p = &((*p)->siguiente));
+	*p = mut->siguiente;
+
+	mut->estado = LIBRE;
+	mut->siguiente = mut_libres;
+	mut_libres = mut;
+	num_mut_total--;
+
+	registrar(LOG_INFO, "%s %s eliminado\n", nombre_primitiva[mut->primitiva], mut->nombre);
+
+	despertar_creador();
+}
+
+//cierra un descriptor de un proceso; si era el ultimo abierto del mutex, lo elimina
+void cerrar_descriptor(BCPptr proc, int desc){
+	MUTptr mut = proc->conj_descriptores[desc];
+
+	//si el proceso lo tenia bloqueado, se desbloquea y deja de heredar por el
+	if (mut->primitiva == PRIM_RW) {
+		if (proc->lectura_desc[desc])
+			soltar_lectura(proc, mut, desc);
+		else if (poseedor_mut(mut) == proc->id) {
+			proc->conj_descriptores[desc] = NULL;
+			soltar_escritura(proc, mut);
+		}
+	}
+	else if (poseedor_mut(mut) == proc->id) {
+		soltar_mutex(mut);
+		proc->conj_descriptores[desc] = NULL;
+		recalcular_prioridad(proc);
+	}
+
+	proc->conj_descriptores[desc] = NULL;
+	proc->n_descriptores_usados--;
+
+	if (--mut->num_abiertos == 0)
+		eliminar_mutex(mut);
+}
+
+//cierre implicito de los mutex que un proceso tiene abiertos al terminar
+void cerrar_descriptores_mutex(BCPptr proc){
+	int i;
+
+	for (i = 0; proc->n_descriptores_usados > 0 && i < proc->tam_descriptores; i++)
+		if (proc->conj_descriptores[i] != NULL)
+			cerrar_descriptor(proc, i);
+}
+
+
+/*Enunciado práctica: Cuando se crea un mutex, el proceso obtiene el descriptor que le permite 
+	acceder al mismo. Si ya existe un mutex con ese nombre o no quedan 
+	descriptores libres, se devuelve un error. En caso de que no haya error, se 
+	debe comprobar si se ha alcanzado el número máximo de mutex en el 
+	sistema. Si esto ocurre, se debe bloquear al proceso hasta que se elimine 
+	algún mutex. La operación que crea el mutex también lo deja abierto para 
+	poder ser usado, devolviendo un descriptor que permita usarlo. Se recibirá 
+	como parámetro de qué tipo es el mutex (recursivo o no)*/
+
+int crear_mutex(char *nombre, int tipo){
+
+	nombre = (char*) leer_registro(1); 
+ 	tipo = (int) leer_registro(2);
+
+	return crear_objeto_mut(nombre, PRIM_MUTEX, tipo);
+
+}
+
+//funcion auxiliar comun a las llamadas de creacion: crea el objeto de la
+//primitiva indicada y lo deja abierto; el significado de tipo depende de
+//la primitiva (ver tipo_valido)
+int crear_objeto_mut(char *nombre, int primitiva, int tipo){
+
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
+
+
+	//Comprobamos que el nombre no excede el maximo de caracteres
+	if(strlen(nombre) > (MAX_NOM_MUT-1) ) {
+
+		registrar(LOG_ERROR, "ERROR MINIKERNEL: %s excede el max de caracteres (%d/%d)\n",nombre,(int)strlen(nombre),MAX_NOM_MUT-1);
+		fijar_nivel_int(n_interrupcion);
+
+		return -1; //se cierra con codigo de error
+
+	}
+
+	if(!tipo_valido(primitiva, tipo)) {
+
+		registrar(LOG_ERROR, "ERROR KERNEL. Tipo de %s %d no valido.\n", nombre_primitiva[primitiva], tipo);
+		fijar_nivel_int(n_interrupcion);
+		return -1;
+
+	}
+
+	int descriptor_resultado = buscar_hueco_descriptores(); //almacenamos el resultado de buscar hueco para no llamar otra vez a la funcion en el if
+
+	if( descriptor_resultado == -1){ //Control de erorr: si no nos da un hueco sale de la funcion
+ 
+		registrar(LOG_ERROR, "ERROR KERNEL. No hay hueco de descriptor.\n");
+		fijar_nivel_int(n_interrupcion);
+		return -1; // Devolvemos el error
+
+	} 
+
+	//Si se ha alcanzado la cuota de mutex del sistema se bloquea hasta que se elimine alguno.
+	//Al despertar se vuelve a comprobar el nombre, que otro proceso ha podido crear mientras tanto
+	int despertado = 0;
+	while (1) {
+
+		//Si ya existe un mutex con ese nombre se devuelve un error 
+		if(buscar_mut_nombre(nombre) != NULL) {
+		
+			registrar(LOG_ERROR, "ERROR KERNEL. Nombre %s en uso.\n", nombre);
+			if (despertado)
+				despertar_creador(); //el hueco liberado pasa al siguiente que espera
+			fijar_nivel_int(n_interrupcion);
+			return -1; // Devolvemos el error
+
+		}
+
+		if (max_mut == 0 || num_mut_total < max_mut)
+			break;
+
+		registrar(LOG_ERROR, "ERROR KERNEL. Numero maximo de mutex alcanzado en el sistema.\n");
+		bloquear(&lista_esperando_mut); //la funcion ya se encarga de actualizar listas y pasar al siguiente proceso
+		despertado = 1;
+
+	}
+
+	if (mut_libres == NULL && ampliar_slab_mut() < 0) {
+
+		registrar(LOG_ERROR, "ERROR KERNEL. Sin memoria para el mutex %s.\n", nombre);
+		if (despertado)
+			despertar_creador();
+		fijar_nivel_int(n_interrupcion);
+		return -1;
+
+	}
+
+	MUTptr mutex_actual = mut_libres;
+	mut_libres = mutex_actual->siguiente;
+
+	strcpy(mutex_actual->nombre, nombre);
+	mutex_actual->estado = OCUPADO;
+	mutex_actual->primitiva = primitiva;
+	if (primitiva == PRIM_MUTEX) {
+		mutex_actual->futex.tipo = tipo;
+		mutex_actual->futex.palabra = 0;
+	}
+	else {
+		//el camino rapido de libserv solo sirve para un mutex
+		mutex_actual->futex.tipo = NO_RECURSIVO;
+		mutex_actual->futex.palabra = FUTEX_ESPERANDO;
+		if (primitiva == PRIM_RW)
+			mutex_actual->preferencia = tipo;
+		else if (primitiva == PRIM_SEM)
+			mutex_actual->valor = tipo;
+	}
+	mutex_actual->futex.profundidad = 0;
+	mutex_actual->futex.estad = buscar_estad_mut(nombre, primitiva);
+	mutex_actual->num_abiertos = 1;
+
+	//se encadena en la entrada hash de su nombre
+	MUTptr *entrada = &tabla_hash_mut[hash_cadena(nombre) & (TAM_HASH_MUT-1)];
+	mutex_actual->siguiente = *entrada;
+	*entrada = mutex_actual;
+	num_mut_total++;
+
+	p_proc_actual->conj_descriptores[descriptor_resultado] = mutex_actual;
+	p_proc_actual->n_descriptores_usados++;
+
+	registrar(LOG_INFO, "%s %s CREADO\n", nombre_primitiva[primitiva], nombre);
+
+	fijar_nivel_int(n_interrupcion);
+	return descriptor_resultado;
+
+}
+
+
+
+/* Devuelve un descriptor asociado a un mutex ya existente o un 
+número negativo en caso de error */
+int abrir_mutex(char *nombre){
+
+	nombre = (char*) leer_registro(1); 
+
+	return abrir_objeto_mut(nombre, PRIM_MUTEX);
+
+}
+
+//funcion auxiliar comun a las llamadas de apertura
+int abrir_objeto_mut(char *nombre, int primitiva){
+
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
+
+	//Comprobamos que el nombre no excede el maximo de caracteres
+	if(strlen(nombre) > (MAX_NOM_MUT-1) ) {
+
+		registrar(LOG_ERROR, "ERROR MINIKERNEL: %s excede el max de caracteres (%d/%d)\n",nombre,(int)strlen(nombre),MAX_NOM_MUT-1);
+		fijar_nivel_int(n_interrupcion);
+
+		return -1; //se cierra con codigo de error
+
+	}
+
+	//Si no existe un mutex con ese nombre se devuelve un error 
+	MUTptr mut = buscar_mut_nombre(nombre);
+	if(mut == NULL) {
+		
+		registrar(LOG_ERROR, "ERROR KERNEL. Nombre -> %s no existente.\n", nombre);
+		fijar_nivel_int(n_interrupcion);
+		return -1; // Devolvemos el error
+
+	}
+
+	if(mut->primitiva != primitiva) {
+
+		registrar(LOG_ERROR, "ERROR KERNEL. %s no es un %s.\n", nombre, nombre_primitiva[primitiva]);
+		fijar_nivel_int(n_interrupcion);
+		return -1;
+
+	}
+
+	int descriptor_resultado = buscar_hueco_descriptores(); //almacenamos el resultado de buscar hueco para no llamar otra vez a la funcion en el if
+
+	if( descriptor_resultado == -1){ //Control de error: si no nos da un hueco sale de la funcion
+ 
+		registrar(LOG_ERROR, "ERROR KERNEL. No hay hueco de descriptor.\n");
+		fijar_nivel_int(n_interrupcion);
+		return -1; // Devolvemos el error
+
+	} 
+
+	p_proc_actual->conj_descriptores[descriptor_resultado] = mut; 
+	p_proc_actual->n_descriptores_usados++;
+	mut->num_abiertos++;
+
+	registrar(LOG_INFO, "%s %s ABIERTO\n",nombre_primitiva[primitiva],nombre); 
+	fijar_nivel_int(n_interrupcion); 
+
+	//Si se encuentra el hueco, se devuelve
+	return descriptor_resultado;
+
+
+}
+
+int lock(unsigned int mutexid){
+
+	mutexid = (unsigned int) leer_registro(1);	
+
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
+
+	MUTptr mut = objeto_de_descriptor(mutexid, PRIM_MUTEX);
+	if(mut == NULL){
+
+		registrar(LOG_ERROR, "ERROR. Descriptor de mutex %d no valido.\n", mutexid);
+		fijar_nivel_int(n_interrupcion);
+		return -1;
+
+	}
+
+	/* libserv ya ha intentado el camino rapido; aqui se llega por contienda,
+	   por un descriptor que no conoce o por un error */
+	int poseedor = poseedor_mut(mut);
+
+	//no tiene propietario -> lo cojo
+	if(poseedor == -1) {
+
+		mut->futex.palabra = FUTEX_POSEEDOR(p_proc_actual->id);
+		mut->futex.profundidad = 1;
+		anotar_adquisicion(mut, p_proc_actual, 0);
+
+		registrar(LOG_DEPURACION, "Mutex %s BLOQUEADO\n",mut->nombre);
+
+		fijar_nivel_int(n_interrupcion);
+		return 0;
+
+	} 
+
+	//lo tiene otro -> espera en la cola del mutex hasta que se lo ceda
+	if(poseedor != p_proc_actual->id) {
+
+		if(detectar_interbloqueo(mut)) {
+			fijar_nivel_int(n_interrupcion);
+			return ERR_INTERBLOQUEO;
+		}
+
+		registrar(LOG_DEPURACION, "Proceso %d esperando el mutex %s (poseido por %d)\n",
+			p_proc_actual->id,mut->nombre,poseedor);
+		//el poseedor tendra que entrar al nucleo para soltarlo
+		mut->futex.palabra |= FUTEX_ESPERANDO;
+		mut->n_mut_espera++;
+		p_proc_actual->mutex_esperado = mut;
+		p_proc_actual->inicio_espera = ticks_sistema;
+		heredar_prioridad(mut, p_proc_actual->prioridad);
+		bloquear(&(mut->lista_mut_espera));
+
+		//al despertar ya es el poseedor: soltar_mutex se lo ha cedido
+		fijar_nivel_int(n_interrupcion);
+		return 0;
+
+	}
+
+	//ya es mio: solo se puede volver a bloquear si es recursivo
+	if(mut->futex.tipo == NO_RECURSIVO){
+
+		registrar(LOG_ERROR, "ERROR. Mutex no recursivo ya bloqueado.\n");
+		fijar_nivel_int(n_interrupcion);
+		return -1;
+
+	}
+
+	mut->futex.profundidad++;
+	anotar_profundidad(mut);
+	fijar_nivel_int(n_interrupcion);
+	return 0;
+
+}
+
+
+int unlock(unsigned int mutexid){
+	
+	mutexid = (unsigned int) leer_registro(1);	
+
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
+
+	MUTptr mut = objeto_de_descriptor(mutexid, PRIM_MUTEX);
+	if(mut == NULL){
+
+		registrar(LOG_ERROR, "ERROR. Descriptor de mutex %d no valido.\n", mutexid);
+		fijar_nivel_int(n_interrupcion);
+		return -1;
+
+	}
+
+	if(poseedor_mut(mut) != p_proc_actual->id) {
+
+		registrar(LOG_ERROR, "ERROR. Mutex %s no bloqueado por el proceso %d\n",mut->nombre,p_proc_actual->id);
+		fijar_nivel_int(n_interrupcion);
+		return -1;
+
+	}
+
+	if(--mut->futex.profundidad == 0) {
+		soltar_mutex(mut);
+		recalcular_prioridad(p_proc_actual);
+	}
+
+	fijar_nivel_int(n_interrupcion);
+	return 0;
+
+}
+
+
+
+int cerrar_mutex(unsigned int mutexid){
+
+	mutexid = (unsigned int) leer_registro(1);	
+
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
+
+	if(objeto_de_descriptor(mutexid, PRIM_MUTEX) == NULL){
+
+		registrar(LOG_ERROR, "ERROR. Descriptor de mutex %d no valido.\n", mutexid);
+		fijar_nivel_int(n_interrupcion);
+		return -1;
+
+	}
+
+	cerrar_descriptor(p_proc_actual, mutexid);
+
+	fijar_nivel_int(n_interrupcion);
+
+	return 0;
 
-	 
-	actual->estado = BLOQUEADO;
+}
 
 
-	//reajustar listas de BCPs
-	//	1º: eliminar de listos
-	eliminar_elem(&lista_listos,p_proc_actual);
 
-	//	2º: añadir a bloqueados
-	insertar_ultimo(&lista_bloqueados,p_proc_actual);
+/*
+ *
+ * Cerrojos de lectores/escritores. Comparten con los mutex el espacio de
+ * nombres, el slab y la tabla de descriptores. Varios lectores pueden
+ * tenerlo a la vez; el escritor lo posee en exclusiva como un mutex, asi
+ * que hereda prioridad de los que esperan
+ *
+ */
 
+//reparte un rwlock sin escritor entre los que esperan: pasa a un escritor si
+//ya no quedan lectores y tiene preferencia o no hay lectores esperando; si
+//no, entran todos los lectores salvo que un escritor con preferencia espere
+void conceder_rw(MUTptr rw){
+	BCPptr p;
 
-	p_proc_actual = planificador();
+	if (rw->num_lectores == 0 && rw->n_mut_espera > 0 &&
+			(rw->preferencia == RW_PREF_ESCRITORES || rw->n_lect_espera == 0)) {
+		ceder_mutex(rw);
+		return;
+	}
 
-	
+	if (rw->preferencia == RW_PREF_ESCRITORES && rw->n_mut_espera > 0)
+		return;
 
-	//Como actual es un puntero del BCP debemos seguir rabajando con puntores en el cambio de contecto
-	//p_proc_actual sera el proceso que se va a derpertar y actual sera el que se va a bloquear y queremos dormir
-	cambio_contexto(&(actual->contexto_regs),&(p_proc_actual->contexto_regs));
+	if (rw->n_lect_espera > 0)
+		registrar(LOG_DEPURACION, "El rwlock %s pasa a %d lectores mas\n", rw->nombre, rw->n_lect_espera);
 
+	while ((p = rw->lista_lect_espera.primero) != NULL) {
+		eliminar_primero(&(rw->lista_lect_espera));
+		rw->n_lect_espera--;
+		rw->num_lectores++;	//cada lector marca su descriptor al despertar
+		p->mutex_esperado = NULL;
+		anotar_adquisicion(rw, p, 1);
+		p->estado = LISTO;
+		insertar_listo(p);
+	}
 }
 
-/*	FUNCION DORMIR 		*/
-int dormir(unsigned int segundos){
+//el proceso deja el cerrojo de lectura que tenia por el descriptor desc
+void soltar_lectura(BCPptr proc, MUTptr rw, int desc){
 
-	//dormir llama a bloquear
-	//	-bloquear lo bloquea 
-	//	-actualiza tablas
-	//	-cambia contexto
-	//cuando pasa el tiempo   ****HAY 
-	//
+	proc->lectura_desc[desc] = 0;
+	if (--rw->num_lectores == 0)
+		conceder_rw(rw);
+}
 
-	//El valor pasado a la funcion se guarda en el registro 1 y utilizamos "leer_registro" para leer ese registro
-	unsigned int segundos_espera = (unsigned int)leer_registro(1);
-	
-	
-	//Se multiplican los segundos por los ticks establecidos (en este caso 100)
-	p_proc_actual->tiempo_dormir = segundos_espera * TICK;
+//el proceso deja el cerrojo de escritura y deja de heredar por el
+void soltar_escritura(BCPptr proc, MUTptr rw){
 
-	//guardamos el nivel de interrupcion
-	int n_interrupcion = fijar_nivel_int(NIVEL_3);
+	anotar_liberacion(rw);
+	rw->futex.palabra = FUTEX_ESPERANDO;
+	rw->futex.profundidad = 0;
+	conceder_rw(rw);
+	recalcular_prioridad(proc);
+}
 
-	//poner el proceso en bloqueado
-	bloquear();
+int crear_rwlock(char *nombre, int preferencia){
 
+	nombre = (char*) leer_registro(1);
+	preferencia = (int) leer_registro(2);
 
+	return crear_objeto_mut(nombre, PRIM_RW, preferencia);
 
+}
 
-	//cuando pasa el tiempo
+int abrir_rwlock(char *nombre){
 
-	//vuelve 
+	nombre = (char*) leer_registro(1);
 
-	//Restauramos el nivel de interrupcion
-	fijar_nivel_int(n_interrupcion);
-	return 0;
+	return abrir_objeto_mut(nombre, PRIM_RW);
 
 }
 
-/*        SERVICIOS MUTEX        */
-
+int lock_lectura(unsigned int rwid){
 
+	rwid = (unsigned int) leer_registro(1);
 
-/*Crear mutex:
-	-Crea el mutex con el nombre y tipo especificados. 
-	-Devuelve un entero que representa un descriptor para acceder al mutex. 
-	-En caso de error devuelve un número negativo. 
-	-Habrá que definir dos constantes, que deberían incluirse tanto en el archivo de cabecera usado por los programas 
-	de usuario (“servicios.h”) como en el usado por el sistema operativo 
-	(“kernel.h”), para facilitar la especificación del tipo de mutex 
-	(NO_RECURSIVO y RECURSIVO) */
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
 
+	MUTptr rw = objeto_de_descriptor(rwid, PRIM_RW);
+	if(rw == NULL){
 
+		registrar(LOG_ERROR, "ERROR. Descriptor de rwlock %d no valido.\n", rwid);
+		fijar_nivel_int(n_interrupcion);
+		return -1;
 
+	}
 
-//funcion auxiliar a mutex: "buscar mutex por nombre", devuelve el num de mutex con ese nombre o da error
-int buscar_mut_nombre(char* nombre) {
-    int i = 0;
-    while (i < NUM_MUT) {
-        if (strcmp(lista_mut[i].nombre, nombre) == 0) {
-            return i; //devolver el numero de mutex
-        }
-        i++;
-    }
-    return -1; //Error: nombre no encontrado
-}
+	int poseedor = poseedor_mut(rw);
 
-//Buscar mutex por id, devuelve el num de mutex con ese id o da error
-int buscar_mut_id(unsigned int mutexid){
-	int i = 0;
-	while (i< NUM_MUT) {
+	//no es recursivo ni se puede leer mientras se escribe
+	if(p_proc_actual->lectura_desc[rwid] || poseedor == p_proc_actual->id){
 
-		if(lista_mut[i].id_mut == mutexid) return i; //devolver el numero de mutex
-		i++;
+		registrar(LOG_ERROR, "ERROR. Rwlock %s ya bloqueado por el proceso %d\n", rw->nombre, p_proc_actual->id);
+		fijar_nivel_int(n_interrupcion);
+		return -1;
 
 	}
 
-	return -1; //Error: nombre no encontrado
+	//hay escritor o, con preferencia de escritores, alguno esperando -> espera
+	if(poseedor != -1 || (rw->preferencia == RW_PREF_ESCRITORES && rw->n_mut_espera > 0)) {
 
-}
+		if(detectar_interbloqueo(rw)) {
+			fijar_nivel_int(n_interrupcion);
+			return ERR_INTERBLOQUEO;
+		}
 
+		registrar(LOG_DEPURACION, "Proceso %d esperando para leer %s\n", p_proc_actual->id, rw->nombre);
+		rw->n_lect_espera++;
+		p_proc_actual->mutex_esperado = rw;
+		p_proc_actual->inicio_espera = ticks_sistema;
+		heredar_prioridad(rw, p_proc_actual->prioridad);
+		bloquear(&(rw->lista_lect_espera));
 
+		//al despertar conceder_rw ya lo ha contado como lector
 
-	//funcion auxiliar a mutex: busca un hueco en el array de descriptores
-int buscar_hueco_descriptores() {
-    int i = 0;
-    while (i < NUM_MUT_PROC) {
-        if (p_proc_actual->conj_descriptores[i] == -1) { //significa que es un hueco
-            return i; //igual que buscando por nombre, devuelve el indice del hueco buscado
-        }
-        i++;
-    }
-    return -1; //Error: no se encuentra hueco de descriptor
-}
+	}
+	else {
+		rw->num_lectores++;
+		anotar_adquisicion(rw, p_proc_actual, 0);
+	}
 
+	p_proc_actual->lectura_desc[rwid] = 1;
 
+	fijar_nivel_int(n_interrupcion);
+	return 0;
 
-	//funcion auxiliar a mutex: buscamos un hueco de mutex
-int buscar_hueco_mutex() { 
-    int i = 0; 
-    while (i < NUM_MUT) { 
-        if (lista_mut[i].estado == LIBRE) { 
-            return i; /* devuelve la posicion del mutex libre */ 
-        } 
-        i++; 
-    } 
-    return -1; /* devuelve -1 si no se encuentra ningún mutex libre */
 }
 
+int lock_escritura(unsigned int rwid){
 
+	rwid = (unsigned int) leer_registro(1);
 
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
 
+	MUTptr rw = objeto_de_descriptor(rwid, PRIM_RW);
+	if(rw == NULL){
 
-/*Enunciado práctica: Cuando se crea un mutex, el proceso obtiene el descriptor que le permite 
-	acceder al mismo. Si ya existe un mutex con ese nombre o no quedan 
-	descriptores libres, se devuelve un error. En caso de que no haya error, se 
-	debe comprobar si se ha alcanzado el número máximo de mutex en el 
-	sistema. Si esto ocurre, se debe bloquear al proceso hasta que se elimine 
-	algún mutex. La operación que crea el mutex también lo deja abierto para 
-	poder ser usado, devolviendo un descriptor que permita usarlo. Se recibirá 
-	como parámetro de qué tipo es el mutex (recursivo o no)*/
+		registrar(LOG_ERROR, "ERROR. Descriptor de rwlock %d no valido.\n", rwid);
+		fijar_nivel_int(n_interrupcion);
+		return -1;
 
-int crear_mutex(char *nombre, int tipo){
+	}
 
-	nombre = (char*) leer_registro(1); 
- 	tipo = (int) leer_registro(2);
+	int poseedor = poseedor_mut(rw);
 
-	int n_interrupcion = fijar_nivel_int(NIVEL_1);
+	if(p_proc_actual->lectura_desc[rwid] || poseedor == p_proc_actual->id){
 
+		registrar(LOG_ERROR, "ERROR. Rwlock %s ya bloqueado por el proceso %d\n", rw->nombre, p_proc_actual->id);
+		fijar_nivel_int(n_interrupcion);
+		return -1;
 
-	//Comprobamos que el nombre no excede el maximo de caracteres
-	if(strlen(nombre) > (MAX_NOM_MUT-1) ) {
+	}
 
-		printk("ERROR MINIKERNEL: %s excede el max de caracteres (%d/%d) ",nombre,strlen(nombre),MAX_NOM_MUT);
-		fijar_nivel_int(n_interrupcion);
+	//libre del todo -> lo cojo
+	if(poseedor == -1 && rw->num_lectores == 0) {
 
-		return -1; //se cierra con codigo de error
+		rw->futex.palabra = FUTEX_POSEEDOR(p_proc_actual->id) | FUTEX_ESPERANDO;
+		rw->futex.profundidad = 1;
+		anotar_adquisicion(rw, p_proc_actual, 0);
 
 	}
+	else {
 
-	
-	//Si ya existe un mutex con ese nombre se devuelve un error 
-	if(buscar_mut_nombre(nombre) != -1) {
-		
-		printk("ERROR KERNEL. Nombre %s en uso.\n", nombre);
-		fijar_nivel_int(n_interrupcion);
-		return -1; // Devolvemos el error
+		if(detectar_interbloqueo(rw)) {
+			fijar_nivel_int(n_interrupcion);
+			return ERR_INTERBLOQUEO;
+		}
 
-	}
-	
-	int descriptor_resultado = buscar_hueco_descriptores(); //almacenamos el resultado de buscar hueco para no llamar otra vez a la funcion en el if
+		registrar(LOG_DEPURACION, "Proceso %d esperando para escribir %s\n", p_proc_actual->id, rw->nombre);
+		rw->n_mut_espera++;
+		p_proc_actual->mutex_esperado = rw;
+		p_proc_actual->inicio_espera = ticks_sistema;
+		heredar_prioridad(rw, p_proc_actual->prioridad);
+		bloquear(&(rw->lista_mut_espera));
 
-	if( descriptor_resultado == -1){ //Control de erorr: si no nos da un hueco sale de la funcion
- 
-		printk("ERROR KERNEL. No hay hueco de descriptor.\n");
-		fijar_nivel_int(n_interrupcion);
-		return -1; // Devolvemos el error
+		//al despertar ya es el escritor: ceder_mutex se lo ha pasado
 
-	} 
+	}
 
+	fijar_nivel_int(n_interrupcion);
+	return 0;
 
-	int mutex_resultado = 0;
-	
-	// ^^^^^^^^^^^^^^^^^=204020i2        EXPLICAR QUE HACE ESTO         399999999999999999991200000000000000000000000000000000000
-	while (mutex_resultado == 0) {
+}
 
-		int descriptor_hueco_mutex = buscar_hueco_mutex();   //Teniendo nombre y descriptor libres, buscamos un hueco en el mutex
+int unlock_rw(unsigned int rwid){
 
-		//Caso positivo comienza todo el proceso de creacion del mutex
-		if (descriptor_hueco_mutex != -1) {
+	rwid = (unsigned int) leer_registro(1);
 
-			//puntero al mutex del hueco que hemos buscado
-			MUTptr mutex_actual = &lista_mut[descriptor_hueco_mutex];   //CREO, NO LO SÉ 
-			
-			// Copiamos el string
-			strncpy(mutex_actual->nombre, nombre, MAX_NOM_MUT);
-		
-			
-			mutex_actual->estado = OCUPADO;
-			mutex_actual->id_mut=num_mut_total++;
-			//num_mut_total++;
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
 
+	MUTptr rw = objeto_de_descriptor(rwid, PRIM_RW);
+	if(rw == NULL){
 
-			p_proc_actual->conj_descriptores[descriptor_resultado] = descriptor_hueco_mutex;
+		registrar(LOG_ERROR, "ERROR. Descriptor de rwlock %d no valido.\n", rwid);
+		fijar_nivel_int(n_interrupcion);
+		return -1;
 
-			printf("Mutex con nombre %s e id %d creado correctamente\n", nombre, mutex_actual->id_mut);
+	}
 
-			mutex_resultado = 1;
-	
+	if(p_proc_actual->lectura_desc[rwid])
+		soltar_lectura(p_proc_actual, rw, rwid);
+	else if(poseedor_mut(rw) == p_proc_actual->id)
+		soltar_escritura(p_proc_actual, rw);
+	else {
 
-		} else { //caso negativo: no hay hueco para el mutex mostramos error y bloqueamos el proceso
+		registrar(LOG_ERROR, "ERROR. Rwlock %s no bloqueado por el proceso %d\n", rw->nombre, p_proc_actual->id);
+		fijar_nivel_int(n_interrupcion);
+		return -1;
 
-			printk("ERROR KERNEL. Numero maximo de mutex alcanzado en el sistema.\n");
-			
-			//bloquear proceso HASTA QUE SE ELMINE ALGÚN MUTEX
+	}
 
+	fijar_nivel_int(n_interrupcion);
+	return 0;
 
+}
 
-			//¿se puede hacer sin pararlo todo con un bucle/similares?  <<<<<<<<<<<===========================================
+int cerrar_rwlock(unsigned int rwid){
 
+	rwid = (unsigned int) leer_registro(1);
 
-			mutex_resultado = 0;
-			bloquear(); //la funcion ya se encarga de actualizar listas y pasar al siguiente proceso
-			
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
 
+	if(objeto_de_descriptor(rwid, PRIM_RW) == NULL){
 
-		}
+		registrar(LOG_ERROR, "ERROR. Descriptor de rwlock %d no valido.\n", rwid);
+		fijar_nivel_int(n_interrupcion);
+		return -1;
 
 	}
 
+	cerrar_descriptor(p_proc_actual, rwid);
 
 	fijar_nivel_int(n_interrupcion);
-	return descriptor_resultado;
+
+	return 0;
 
 }
 
 
 
-/* Devuelve un descriptor asociado a un mutex ya existente o un 
-número negativo en caso de error */
-int abrir_mutex(char *nombre){
+/*
+ *
+ * Semaforos contadores y variables condicion. Tambien son objetos de la
+ * tabla de mutex, sin poseedor: sus procesos bloqueados esperan en
+ * lista_mut_espera. Una variable condicion se usa junto a un mutex y, al
+ * señalarla, el proceso despertado pasa directamente a la cola de ese
+ * mutex (wait-morphing) en vez de despertar para volver a bloquearse
+ *
+ */
 
-	nombre = (char*) leer_registro(1); 
+int crear_semaforo(char *nombre, int valor){
 
-	int n_interrupcion = fijar_nivel_int(NIVEL_1);
+	nombre = (char*) leer_registro(1);
+	valor = (int) leer_registro(2);
 
-	//Comprobamos que el nombre no excede el maximo de caracteres
-	if(strlen(nombre) > (MAX_NOM_MUT-1) ) {
+	return crear_objeto_mut(nombre, PRIM_SEM, valor);
 
-		printk("ERROR MINIKERNEL: %s excede el max de caracteres (%d/%d) ",nombre,strlen(nombre),MAX_NOM_MUT);
-		fijar_nivel_int(n_interrupcion);
+}
 
-		return -1; //se cierra con codigo de error
+int abrir_semaforo(char *nombre){
 
-	}
+	nombre = (char*) leer_registro(1);
 
-	
+	return abrir_objeto_mut(nombre, PRIM_SEM);
 
-	//buscar nombre
-	//Si no existe un mutex con ese nombre se devuelve un error 
+}
 
-	int mutex_buscado = buscar_mut_nombre(nombre);
-	if(mutex_buscado == -1) {
-		
-		printk("ERROR KERNEL. Nombre -> %s no existente.\n", nombre);
-		fijar_nivel_int(n_interrupcion);
-		return -1; // Devolvemos el error
+int wait_sem(unsigned int semid){
 
-	}
+	semid = (unsigned int) leer_registro(1);
 
-	int descriptor_resultado = buscar_hueco_descriptores(); //almacenamos el resultado de buscar hueco para no llamar otra vez a la funcion en el if
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
 
-	if( descriptor_resultado == -1){ //Control de error: si no nos da un hueco sale de la funcion
- 
-		printk("ERROR KERNEL. No hay hueco de descriptor.\n");
+	MUTptr sem = objeto_de_descriptor(semid, PRIM_SEM);
+	if(sem == NULL){
+
+		registrar(LOG_ERROR, "ERROR. Descriptor de semaforo %d no valido.\n", semid);
 		fijar_nivel_int(n_interrupcion);
-		return -1; // Devolvemos el error
+		return -1;
 
-	} 
+	}
 
-	p_proc_actual->conj_descriptores[descriptor_resultado] = mutex_buscado; 
-	p_proc_actual->n_descriptores_usados++;
+	if(sem->valor > 0) {
+		sem->valor--;
+		anotar_adquisicion(sem, p_proc_actual, 0);
+	}
+	else {
 
-	printk("Mutex %s ABIERTO\n",nombre); 
-	fijar_nivel_int(n_interrupcion); 
+		//signal_sem pasa la unidad directamente al despertarlo
+		sem->n_mut_espera++;
+		p_proc_actual->inicio_espera = ticks_sistema;
+		bloquear(&(sem->lista_mut_espera));
 
-	//Si se encuentra el hueco, se devuelve
-	return descriptor_resultado;
+	}
 
+	fijar_nivel_int(n_interrupcion);
+	return 0;
 
 }
 
-int lock(unsigned int mutexid){
+int signal_sem(unsigned int semid){
 
-	unsigned int mut_id = (unsigned int) leer_registro(1);	
+	semid = (unsigned int) leer_registro(1);
 
-	int n_interrupcion = fijar_nivel_int(NIVEL_1);
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
 
-	//si el id es menor que NUM MUT es que ✅
-	if(mut_id >= NUM_MUT){
+	MUTptr sem = objeto_de_descriptor(semid, PRIM_SEM);
+	if(sem == NULL){
 
-		printk("ERROR. ID de mutex %d fuera de rango.\n", mut_id);
+		registrar(LOG_ERROR, "ERROR. Descriptor de semaforo %d no valido.\n", semid);
 		fijar_nivel_int(n_interrupcion);
 		return -1;
 
-	} mutexid = mut_id;
+	}
+
+	if(sem->n_mut_espera > 0) {
+
+		BCPptr p = sem->lista_mut_espera.primero;
+		eliminar_primero(&(sem->lista_mut_espera));
+		sem->n_mut_espera--;
+		anotar_adquisicion(sem, p, 1);
+		p->estado = LISTO;
+		insertar_listo(p);
 
-	int resultado_busqueda = buscar_mut_id((int)mut_id);
-	if(resultado_busqueda == -1){
-		printk("ERROR. ID de mutex %d no encontrado\n",mut_id);
-		fijar_nivel_int(n_interrupcion);
-		return -1;
 	}
+	else
+		sem->valor++;
+
+	fijar_nivel_int(n_interrupcion);
+	return 0;
 
-	int posicion_mut = resultado_busqueda+1;
+}
 
-	MUTptr mut = &lista_mut[posicion_mut];
+int cerrar_semaforo(unsigned int semid){
 
-	
+	semid = (unsigned int) leer_registro(1);
 
-	while (1) {
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
 
-		/*¿Tiene propietario? 
-			no tiene y no tiene bloqueos -> lo cojo
-				- id_dueño = yo
-				- num_mut_bloqueos ++
-				- n_interrupcion y return
-		
-		*/
+	if(objeto_de_descriptor(semid, PRIM_SEM) == NULL){
+
+		registrar(LOG_ERROR, "ERROR. Descriptor de semaforo %d no valido.\n", semid);
+		fijar_nivel_int(n_interrupcion);
+		return -1;
 
-		if(mut->id_poseedor_mut == -1 && mut->num_mut_bloqueos == 0) {
+	}
 
-			mut->id_poseedor_mut = p_proc_actual->id;
-			mut->num_mut_bloqueos++;
-			mut->estado_bloqueo_mut = MUT_BLOQUEADO;
+	cerrar_descriptor(p_proc_actual, semid);
 
-			printk("Mutex %s BLOQUEADO\n",mut->nombre);
+	fijar_nivel_int(n_interrupcion);
 
-			fijar_nivel_int(n_interrupcion);
-			return resultado_busqueda;
+	return 0;
 
-		} 
+}
 
-		if(mut->id_poseedor_mut != p_proc_actual->id) {
+//despierta al primero que espera en la condicion: si su mutex esta libre se
+//lo da y lo pasa a listo; si no, lo mueve a la cola del mutex, donde sigue
+//bloqueado hasta que se lo cedan
+void despertar_cond(MUTptr cond){
+	BCPptr p = cond->lista_mut_espera.primero;
+	MUTptr mut = p->mutex_cond;
 
-			printk("ERROR. Mutex ya poseido por proceso %d.\n",mut->id_poseedor_mut);
-			fijar_nivel_int(n_interrupcion);
-			return -1;
+	eliminar_primero(&(cond->lista_mut_espera));
+	cond->n_mut_espera--;
 
-		}
+	if(poseedor_mut(mut) == -1) {
 
-		if(mut->id_poseedor_mut == p_proc_actual->id){
+		mut->futex.palabra = FUTEX_POSEEDOR(p->id);
+		mut->futex.profundidad = 1;
+		anotar_adquisicion(mut, p, 0);
+		p->estado = LISTO;
+		insertar_listo(p);
+		recalcular_prioridad(p);
 
-			if(mut->tipo == NO_RECURSIVO){
+	}
+	else {
 
-				printk("ERROR. Mutex no recursivo ya bloqueado.");
-				fijar_nivel_int(n_interrupcion);
-				return -1;
+		registrar(LOG_DEPURACION, "Proceso %d pasa de la condicion %s al mutex %s\n",
+			p->id, cond->nombre, mut->nombre);
+		mut->futex.palabra |= FUTEX_ESPERANDO;
+		mut->n_mut_espera++;
+		p->inicio_espera = ticks_sistema;
+		insertar_ultimo(&(mut->lista_mut_espera), p);
+		p->mutex_esperado = mut;
+		heredar_prioridad(mut, p->prioridad);
 
-			}
+	}
+}
 
-			
-			mut->num_mut_bloqueos++;
-			fijar_nivel_int(n_interrupcion);
-			return resultado_busqueda;
+int crear_condicion(char *nombre){
 
+	nombre = (char*) leer_registro(1);
 
-		}
+	return crear_objeto_mut(nombre, PRIM_COND, 0);
 
+}
 
+int abrir_condicion(char *nombre){
 
-	}
+	nombre = (char*) leer_registro(1);
 
+	return abrir_objeto_mut(nombre, PRIM_COND);
 
 }
 
+int wait_cond(unsigned int condid, unsigned int mutexid){
 
-int unlock(unsigned int mutexid){
-	
-	unsigned int mut_id = (unsigned int) leer_registro(1);	
+	condid = (unsigned int) leer_registro(1);
+	mutexid = (unsigned int) leer_registro(2);
 
-	int n_interrupcion = fijar_nivel_int(NIVEL_1);
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
 
-	//si el id es menor que NUM MUT es que ✅
-	if(mut_id >= NUM_MUT){
+	MUTptr cond = objeto_de_descriptor(condid, PRIM_COND);
+	MUTptr mut = objeto_de_descriptor(mutexid, PRIM_MUTEX);
+	if(cond == NULL || mut == NULL){
 
-		printk("ERROR. ID de mutex %d fuera de rango.\n", mut_id);
+		registrar(LOG_ERROR, "ERROR. Descriptores de condicion %d y mutex %d no validos.\n", condid, mutexid);
 		fijar_nivel_int(n_interrupcion);
 		return -1;
 
-	} mutexid = mut_id;
+	}
 
+	if(poseedor_mut(mut) != p_proc_actual->id) {
 
-	int resultado_busqueda = buscar_mut_id((int)mut_id);
-	if(resultado_busqueda == -1){
-		printk("ERROR. ID de mutex %d no encontrado\n",mut_id);
+		registrar(LOG_ERROR, "ERROR. Mutex %s no bloqueado por el proceso %d\n",mut->nombre,p_proc_actual->id);
 		fijar_nivel_int(n_interrupcion);
 		return -1;
-	}
 
-	int posicion_mut = resultado_busqueda+1;
+	}
 
-	MUTptr mut = &lista_mut[posicion_mut];
+	//suelta del todo el mutex, aunque sea recursivo, y espera en la condicion
+	p_proc_actual->mutex_cond = mut;
+	p_proc_actual->profundidad_cond = mut->futex.profundidad;
+	soltar_mutex(mut);
+	recalcular_prioridad(p_proc_actual);
 
-	if(mut->num_mut_bloqueos == 0) {
+	cond->n_mut_espera++;
+	bloquear(&(cond->lista_mut_espera));
 
-		printk("ERROR. Mutex con id %d no estaba bloqueado\n",mut_id);
-		fijar_nivel_int(n_interrupcion);
-		return -1;
+	//al despertar ya vuelve a ser el poseedor del mutex
+	mut->futex.profundidad = p_proc_actual->profundidad_cond;
 
-	}
+	fijar_nivel_int(n_interrupcion);
+	return 0;
 
-	if(mut->num_mut_bloqueos == 1) {
+}
 
-		mut->estado_bloqueo_mut = MUT_DESBLOQUEADO;
-		mut->id_poseedor_mut = -1;
+int signal_cond(unsigned int condid){
 
-	}
+	condid = (unsigned int) leer_registro(1);
 
-	mut->num_mut_bloqueos--;
-	printk("El mutex %s ha sido desbloqueado\n",mut->nombre);
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
 
-	if(mut->n_mut_espera >= 1){
+	MUTptr cond = objeto_de_descriptor(condid, PRIM_COND);
+	if(cond == NULL){
 
-		mut->n_mut_espera--;
-		BCPptr p_proc_bloqueando = mut->lista_mut_espera.primero;
-		p_proc_bloqueando->estado = LISTO;
-		eliminar_primero(&(mut->lista_mut_espera));
-		insertar_ultimo(&lista_listos,p_proc_bloqueando);
-		printk("El proceso con id %d ha sido desbloqueado\n",p_proc_bloqueando->id);
+		registrar(LOG_ERROR, "ERROR. Descriptor de condicion %d no valido.\n", condid);
+		fijar_nivel_int(n_interrupcion);
+		return -1;
 
 	}
 
-	fijar_nivel_int(n_interrupcion);
-	return resultado_busqueda;
+	if(cond->n_mut_espera > 0)
+		despertar_cond(cond);
 
+	fijar_nivel_int(n_interrupcion);
+	return 0;
 
 }
 
+int broadcast_cond(unsigned int condid){
 
+	condid = (unsigned int) leer_registro(1);
 
-int cerrar_mutex(unsigned int mutexid){
-
-	unsigned int mut_id = (unsigned int) leer_registro(1);	
-
-	int n_interrupcion = fijar_nivel_int(NIVEL_1);
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
 
-	//si el id es menor que NUM MUT es que ✅
-	if(mut_id >= NUM_MUT){
+	MUTptr cond = objeto_de_descriptor(condid, PRIM_COND);
+	if(cond == NULL){
 
-		printk("ERROR. ID de mutex %d fuera de rango.\n");
+		registrar(LOG_ERROR, "ERROR. Descriptor de condicion %d no valido.\n", condid);
 		fijar_nivel_int(n_interrupcion);
 		return -1;
 
 	}
 
-	mutexid = mut_id;
+	while(cond->n_mut_espera > 0)
+		despertar_cond(cond);
 
-	int resultado_busqueda = buscar_mut_id((int)mut_id);
-	if(resultado_busqueda == -1){
-		printk("ERROR. ID de mutex %d no encontrado\n",mut_id);
-		fijar_nivel_int(n_interrupcion);
-		return -1;
-	}
+	fijar_nivel_int(n_interrupcion);
+	return 0;
+
+}
+
+int cerrar_condicion(unsigned int condid){
 
-	int posicion_mut = resultado_busqueda+1;
+	condid = (unsigned int) leer_registro(1);
 
-	MUTptr mut = &lista_mut[posicion_mut];
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
 
-	while(mut->estado_bloqueo_mut == MUT_BLOQUEADO){
+	if(objeto_de_descriptor(condid, PRIM_COND) == NULL){
 
-		unlock(mutexid);
+		registrar(LOG_ERROR, "ERROR. Descriptor de condicion %d no valido.\n", condid);
+		fijar_nivel_int(n_interrupcion);
+		return -1;
 
 	}
 
-	//Liberamos el proceso 
-	mut->num_mut_bloqueos=0;
-	mut->n_mut_espera=0;
-	mut->estado = LIBRE;
-	p_proc_actual->conj_descriptores[posicion_mut] = -1;
-	p_proc_actual->n_descriptores_usados--;
-	num_mut_total--;
+	cerrar_descriptor(p_proc_actual, condid);
 
-	printk("Cierre del mutex %s completado.\n",mut->nombre);
+	fijar_nivel_int(n_interrupcion);
 
-	if(num_mut_total>=1) { //contador_lista_bloqueados_mutex
+	return 0;
 
-		num_mut_total--;
-		BCPptr p_proc_bloqueando = lista_bloqueados.primero;
-		p_proc_bloqueando->estado = LISTO;
-		eliminar_primero(&lista_bloqueados);
-		insertar_ultimo(&lista_listos,p_proc_bloqueando);
-		printk("Desbloqueo del mutex %s \n",mut->nombre);
+}
 
+//escribe en la consola, tras la salida pendiente, las estadisticas de
+//contienda de los n objetos con mas espera (todos si n es 0)
+int estadisticas_mutex(unsigned int n){
 
-	}
+	n = (unsigned int) leer_registro(1);
 
+	vaciar_salida();
+	int n_interrupcion = fijar_nivel_int(NIVEL_3);
+	informe_lockstat(n);
 	fijar_nivel_int(n_interrupcion);
 
 	return 0;
@@ -1024,15 +3439,21 @@ int main(){
 	listas correspondientes*/
 	//instal_man_int(INT_PLAZO, int_plazo);
 
+	nivel_log=parametro_arranque("nivel_log", NIVEL_LOG);
+	reloj_dinamico=parametro_arranque("reloj_dinamico", RELOJ_DINAMICO);
+
 	iniciar_cont_int();		/* inicia cont. interr. */
 	iniciar_cont_reloj(TICK);	/* fija frecuencia del reloj */
 	iniciar_cont_teclado();		/* inici cont. teclado */
 
 	iniciar_tabla_proc();		/* inicia BCPs de tabla de procesos */
+	iniciar_cache_pilas(parametro_arranque("pilas", PILAS_INICIALES));
 	iniciar_tabla_mut();            /* inicia la tabla de mutex */
+	cola_justos.menor=justo_menor;	/* orden de la clase justa */
+	cola_tr.menor=tr_menor;		/* orden de la clase de tiempo real */
 
 	/* crea proceso inicial */
-	if (crear_tarea((void *)"init")<0)
+	if (crear_tarea((void *)"init", TAM_PILA)<0)
 		panico("no encontrado el proceso inicial");
 	
 	/* activa proceso inicial */
@@ -0,0 +1,34 @@
+/*
+ * usuario/bloqueador.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario que posee el mutex b y espera el mutex a, que posee
+ * prueba_interbloqueo.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int a, b;
+
+	a=abrir_mutex("a");
+	b=abrir_mutex("b");
+	if (a<0 || b<0)
+		printf("error abriendo a y b. NO DEBE APARECER\n");
+
+	if (lock(b)<0)
+		printf("error en lock de b. NO DEBE APARECER\n");
+	if (lock(a)<0)
+		printf("error en lock de a. NO DEBE APARECER\n");
+
+	printf("bloqueador: obtiene a y b\n");
+	unlock(a);
+	unlock(b);
+
+	printf("bloqueador: termina\n");
+	return 0;
+}
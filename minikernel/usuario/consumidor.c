@@ -0,0 +1,46 @@
+/*
+ * usuario/consumidor.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario que espera la condicion hay con el mutex pc
+ * (recursivo, bloqueado dos veces) y despues consume los tres elementos
+ * que produce prueba_cond.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int mut, cond, elementos, huecos, i;
+
+	mut=abrir_mutex("pc");
+	cond=abrir_condicion("hay");
+	elementos=abrir_semaforo("elems");
+	huecos=abrir_semaforo("huecos");
+	if (mut<0 || cond<0 || elementos<0 || huecos<0)
+		printf("error abriendo los objetos. NO DEBE APARECER\n");
+
+	lock(mut);
+	lock(mut);
+	if (wait_cond(cond, mut)<0)
+		printf("error en wait_cond. NO DEBE APARECER\n");
+	printf("consumidor: despierta con el mutex\n");
+
+	/* recupera la profundidad que tenia: hacen falta dos unlock */
+	if (unlock(mut)<0 || unlock(mut)<0)
+		printf("error en unlock de pc. NO DEBE APARECER\n");
+	if (unlock(mut)==0)
+		printf("unlock de mas. NO DEBE APARECER\n");
+
+	for (i=1; i<=3; i++) {
+		wait_sem(elementos);
+		printf("consumidor: consume %d\n", i);
+		signal_sem(huecos);
+	}
+
+	printf("consumidor: termina\n");
+	return 0;
+}
@@ -23,8 +23,9 @@ int main(){
 	printf("dormilon (%d) duerme 1 segundo\n", id);
 	dormir(1);
 
-	/* despues duerme numero de segundos dependiendo de su pid */
-	segs=id+1;
+	/* despues duerme numero de segundos dependiendo de su pid (de la
+	   entrada, que el id crece al reutilizarse) */
+	segs=(id&(MAX_ENTRADAS_PROC-1))+1;
 	printf("dormilon (%d) duerme %d segundos\n", id, segs);
 	dormir(segs);
 
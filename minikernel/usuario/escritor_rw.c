@@ -0,0 +1,30 @@
+/*
+ * usuario/escritor_rw.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario que escribe durante un segundo protegido por el
+ * rwlock rw que crea prueba_rw. Sale sin soltarlo: al cerrarse el
+ * descriptor implicitamente se cede a los lectores que esperan.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int desc;
+
+	if ((desc=abrir_rwlock("rw"))<0)
+		printf("error abriendo rw. NO DEBE APARECER\n");
+
+	if (lock_escritura(desc)<0)
+		printf("error en lock_escritura de rw. NO DEBE APARECER\n");
+
+	printf("escritor_rw: escribiendo. DEBE APARECER ANTES QUE EL SEGUNDO LECTOR\n");
+	dormir(1);
+	printf("escritor_rw: termina sin soltar el rwlock\n");
+
+	return 0;
+}
@@ -0,0 +1,33 @@
+/*
+ * usuario/herencia_alta.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario de prioridad alta que espera el mutex inv, que posee
+ * prueba_herencia con prioridad baja.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int desc;
+
+	printf("herencia_alta: comienza\n");
+
+	if ((desc=abrir_mutex("inv"))<0)
+		printf("error abriendo inv. NO DEBE APARECER\n");
+
+	if (lock(desc)<0)
+		printf("error en lock de inv. NO DEBE APARECER\n");
+
+	printf("herencia_alta: obtiene el mutex. DEBE APARECER ANTES DE QUE TERMINEN LOS yosoy\n");
+
+	if (unlock(desc)<0)
+		printf("error en unlock de inv. NO DEBE APARECER\n");
+
+	printf("herencia_alta: termina\n");
+	return 0;
+}
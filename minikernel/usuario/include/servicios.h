@@ -19,9 +19,46 @@
 #ifndef SERVICIOS_H
 #define SERVICIOS_H
 
+/* anillo de llamadas y pagina de datos compartidos con el nucleo
+   (minikernel/include) */
+#include "anillo.h"
+#include "pagina.h"
+
 /* defines para el mutex  */
 #define NO_RECURSIVO 0
 #define RECURSIVO 1
+#define ERR_INTERBLOQUEO -2	/* lock que cerraria un ciclo de espera */
+
+/* defines para el rwlock */
+#define RW_PREF_LECTORES 0
+#define RW_PREF_ESCRITORES 1
+
+/* defines para el id de proceso: su entrada en la tabla va en los bits
+   bajos y la generacion de la entrada en los altos */
+#define MAX_ENTRADAS_PROC 65536
+
+/* defines para la prioridad (0 es la maxima) */
+#define NUM_PRIORIDADES 32
+#define PRIORIDAD_DEFECTO 16
+
+/* defines para la clase de planificacion */
+#define CLASE_PRIORIDAD 0
+#define CLASE_JUSTA 1
+#define CLASE_TR 2	/* solo mediante fijar_tiempo_real */
+
+/* defines para el modo del terminal */
+#define TERM_CRUDO 0	/* se lee cada caracter segun llega */
+#define TERM_CANONICO 1	/* se leen lineas completas (borrado y control-D) */
+
+/* defines para los niveles del registro del nucleo */
+#define LOG_ERROR 0
+#define LOG_AVISO 1
+#define LOG_INFO 2
+#define LOG_DEPURACION 3	/* por tick, cambio de contexto y operacion */
+
+/* defines para el modo de la consola */
+#define CONSOLA_LINEAS 0	/* la salida se agrupa por lineas */
+#define CONSOLA_DIRECTA 1	/* cada escritura sale en la llamada */
 
 
 
@@ -33,8 +70,62 @@ int escribirf(const char *formato, ...);
 
 /* Llamadas al sistema proporcionadas */
 int crear_proceso(char *prog);
+int crear_proceso_pila(char *prog, unsigned int tam_pila); /* 0: por defecto */
 int terminar_proceso();
 int escribir(char *texto, unsigned int longi);
+int obtener_id_pr();
+int dormir(unsigned int segundos);
+int fijar_tiempo_real(unsigned int periodo, unsigned int presupuesto,
+	unsigned int plazo);
+int esperar_periodo();
+int crear_mutex(char *nombre, int tipo);
+int abrir_mutex(char *nombre);
+int lock(unsigned int mutexid);
+int unlock(unsigned int mutexid);
+int cerrar_mutex(unsigned int mutexid);
+int fijar_prioridad(unsigned int prioridad);
+int fijar_clase(unsigned int clase);
+int crear_rwlock(char *nombre, int preferencia);
+int abrir_rwlock(char *nombre);
+int lock_lectura(unsigned int rwid);
+int lock_escritura(unsigned int rwid);
+int unlock_rw(unsigned int rwid);
+int cerrar_rwlock(unsigned int rwid);
+int crear_semaforo(char *nombre, int valor);
+int abrir_semaforo(char *nombre);
+int wait_sem(unsigned int semid);
+int signal_sem(unsigned int semid);
+int cerrar_semaforo(unsigned int semid);
+int crear_condicion(char *nombre);
+int abrir_condicion(char *nombre);
+int wait_cond(unsigned int condid, unsigned int mutexid);
+int signal_cond(unsigned int condid);
+int broadcast_cond(unsigned int condid);
+int cerrar_condicion(unsigned int condid);
+int estadisticas_mutex(unsigned int n); /* 0: todos */
+int enviar_anillo(anillo_llamsis *anillo); /* peticiones consumidas */
+int leer_caracter(); /* bloquea hasta que haya uno; -1: fin de fichero */
+int leer(char *buf, unsigned int n); /* leidos; 0: fin de fichero */
+int fijar_modo_terminal(int modo); /* devuelve el anterior */
+int leer_log(char *buf, unsigned int tam); /* longitud del texto */
+int fijar_nivel_log(int nivel); /* devuelve el anterior */
+int fijar_consola(int modo); /* devuelve el anterior */
+
+/* Funciones de biblioteca para el anillo de llamadas: encolan una peticion
+   (-1 si el anillo esta lleno) o recogen una respuesta (-1 si no hay) */
+void iniciar_anillo(anillo_llamsis *anillo);
+int encolar_escribir(anillo_llamsis *anillo, char *texto, unsigned int longi, long dato);
+int encolar_obtener_id(anillo_llamsis *anillo, long dato);
+int encolar_dormir(anillo_llamsis *anillo, unsigned int segundos, long dato);
+int encolar_lock(anillo_llamsis *anillo, unsigned int mutexid, long dato);
+int encolar_unlock(anillo_llamsis *anillo, unsigned int mutexid, long dato);
+int recoger_respuesta(anillo_llamsis *anillo, long *dato, int *resultado);
+
+/* Funciones de biblioteca que leen la pagina de datos del nucleo sin
+   llamadas al sistema: el reloj en ticks y una copia coherente de toda la
+   pagina (-1 si el nucleo no la ha publicado) */
+unsigned long obtener_ticks();
+int leer_pagina_kernel(pagina_kernel *copia);
 
 #endif /* SERVICIOS_H */
 
@@ -79,6 +79,76 @@ ALGO COMENTE ESTA PARTE Y DESCOMENTE LA PRUEBA CORRESPONDIENTE */
 		printf("Error creando prueba_RR2\n");
 */
 
+/* PRUEBA DE PRIORIDADES
+	if (crear_proceso("prueba_prio")<0)
+		printf("Error creando prueba_prio\n");
+*/
+
+/* PRUEBA DE LA CLASE JUSTA
+	if (crear_proceso("prueba_justa")<0)
+		printf("Error creando prueba_justa\n");
+*/
+
+/* PRUEBA DE TIEMPO REAL
+	if (crear_proceso("prueba_tr")<0)
+		printf("Error creando prueba_tr\n");
+*/
+
+/* PRUEBA DE LA TABLA DE PROCESOS DINAMICA
+	if (crear_proceso("prueba_procs")<0)
+		printf("Error creando prueba_procs\n");
+*/
+
+/* PRUEBA DE LA CACHE DE PILAS
+	if (crear_proceso("prueba_pilas")<0)
+		printf("Error creando prueba_pilas\n");
+*/
+
+/* PRUEBA DE HERENCIA DE PRIORIDAD EN MUTEX
+	if (crear_proceso("prueba_herencia")<0)
+		printf("Error creando prueba_herencia\n");
+*/
+
+/* PRUEBA DE RWLOCK CON PREFERENCIA DE ESCRITORES
+	if (crear_proceso("prueba_rw")<0)
+		printf("Error creando prueba_rw\n");
+*/
+
+/* PRUEBA DE SEMAFOROS Y VARIABLES CONDICION
+	if (crear_proceso("prueba_cond")<0)
+		printf("Error creando prueba_cond\n");
+*/
+
+/* PRUEBA DE DETECCION DE INTERBLOQUEOS
+	if (crear_proceso("prueba_interbloqueo")<0)
+		printf("Error creando prueba_interbloqueo\n");
+*/
+
+/* PRUEBA DEL ANILLO DE LLAMADAS
+	if (crear_proceso("prueba_anillo")<0)
+		printf("Error creando prueba_anillo\n");
+*/
+
+/* PRUEBA DE LA PAGINA DE DATOS DEL NUCLEO
+	if (crear_proceso("prueba_pagina")<0)
+		printf("Error creando prueba_pagina\n");
+*/
+
+/* PRUEBA DE LA LECTURA POR BLOQUES Y DEL MODO CANONICO
+	if (crear_proceso("prueba_leer")<0)
+		printf("Error creando prueba_leer\n");
+*/
+
+/* PRUEBA DEL REGISTRO DEL NUCLEO
+	if (crear_proceso("prueba_log")<0)
+		printf("Error creando prueba_log\n");
+*/
+
+/* PRUEBA DE LA CONSOLA CON ESCRITURA COMBINADA
+	if (crear_proceso("prueba_consola")<0)
+		printf("Error creando prueba_consola\n");
+*/
+
 /* PRUEBA DEL TERMINAL
 	if (crear_proceso("prueba_term")<0)
 		printf("Error creando prueba_term\n");
@@ -0,0 +1,30 @@
+/*
+ * usuario/justo.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario de CLASE_JUSTA que no hace llamadas: cuenta las
+ * vueltas que da en 3 segundos, leyendo el reloj en la pagina del nucleo.
+ */
+
+#include "servicios.h"
+
+#define DURACION 300	/* ticks */
+
+int main(){
+	unsigned long inicio, vueltas=0;
+	int id;
+
+	id=obtener_id_pr();
+	if (fijar_clase(CLASE_JUSTA)!=CLASE_PRIORIDAD)
+		printf("justo (%d): clase inicial distinta. NO DEBE APARECER\n", id);
+
+	inicio=obtener_ticks();
+	while (obtener_ticks()-inicio < DURACION)
+		vueltas++;
+	printf("justo (%d): %lu vueltas en 3 segundos\n", id, vueltas);
+	return 0;
+}
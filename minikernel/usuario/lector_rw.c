@@ -0,0 +1,33 @@
+/*
+ * usuario/lector_rw.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario que lee durante dos segundos protegido por el
+ * rwlock rw que crea prueba_rw.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int desc;
+	int id=obtener_id_pr();
+
+	if ((desc=abrir_rwlock("rw"))<0)
+		printf("error abriendo rw. NO DEBE APARECER\n");
+
+	if (lock_lectura(desc)<0)
+		printf("error en lock_lectura de rw. NO DEBE APARECER\n");
+
+	printf("lector_rw %d: leyendo\n", id);
+	dormir(2);
+	printf("lector_rw %d: deja de leer\n", id);
+
+	if (unlock_rw(desc)<0)
+		printf("error en unlock_rw de rw. NO DEBE APARECER\n");
+
+	return 0;
+}
@@ -17,6 +17,7 @@
  */
 
 #include "llamsis.h"
+#include "futex.h"
 #include "servicios.h"
 
 /* Funcin del mdulo "misc" que prepara el cdigo de la llamada
@@ -26,6 +27,34 @@
 
 int llamsis(int llamada, int nargs, ... /* args */);
 
+/* Zona de futex del nucleo: la fija el nucleo al cargar la imagen. Con
+   ella lock y unlock resuelven sin llamada al sistema los casos sin
+   contienda; si sigue a nulo se usa siempre la llamada */
+zona_futex *zona_kernel = 0;
+
+/* Pagina de datos del nucleo: tambien la fija el nucleo al cargar la
+   imagen. Solo se lee */
+const pagina_kernel *pagina_datos = 0;
+
+/* Palabra de cerrojo asociada a un descriptor del proceso actual o nulo
+   si no se conoce (descriptor no valido o zona no publicada) */
+static palabra_futex *futex_de(unsigned int mutexid){
+	if (zona_kernel == 0 || mutexid >= zona_kernel->tam_descriptores)
+		return 0;
+	return zona_kernel->descriptores[mutexid];
+}
+
+/* Sube un maximo de las estadisticas. Como el resto de contadores que se
+   tocan sin entrar al nucleo, se actualiza de forma atomica: el nucleo
+   puede interrumpir entre la lectura y la escritura y tambien lo cambia */
+static void subir_maximo(int *maximo, int valor){
+	int actual;
+
+	while ((actual = *maximo) < valor &&
+			!__sync_bool_compare_and_swap(maximo, actual, valor))
+		;
+}
+
 
 /*
  *
@@ -35,7 +64,10 @@ int llamsis(int llamada, int nargs, ... /* args */);
 
 
 int crear_proceso(char *prog){
-	return llamsis(CREAR_PROCESO, 1, (long)prog);
+	return llamsis(CREAR_PROCESO, 2, (long)prog, 0L);
+}
+int crear_proceso_pila(char *prog, unsigned int tam_pila){
+	return llamsis(CREAR_PROCESO, 2, (long)prog, (long)tam_pila);
 }
 int terminar_proceso(){
 	return llamsis(TERMINAR_PROCESO, 0);
@@ -44,3 +76,239 @@ int escribir(char *texto, unsigned int longi){
 	return llamsis(ESCRIBIR, 2, (long)texto, (long)longi);
 }
 
+int obtener_id_pr(){
+	/* una palabra se lee entera: no hace falta el seqlock */
+	if (pagina_datos)
+		return pagina_datos->id;
+	return llamsis(OBTENER_ID, 0);
+}
+int dormir(unsigned int segundos){
+	return llamsis(DORMIR, 1, (long)segundos);
+}
+int fijar_tiempo_real(unsigned int periodo, unsigned int presupuesto,
+		unsigned int plazo){
+	return llamsis(FIJAR_TIEMPO_REAL, 3, (long)periodo, (long)presupuesto,
+		(long)plazo);
+}
+int esperar_periodo(){
+	return llamsis(ESPERAR_PERIODO, 0);
+}
+int crear_mutex(char *nombre, int tipo){
+	return llamsis(CREAR_MUTEX, 2, (long)nombre, (long)tipo);
+}
+int abrir_mutex(char *nombre){
+	return llamsis(ABRIR_MUTEX, 1, (long)nombre);
+}
+int lock(unsigned int mutexid){
+	palabra_futex *f = futex_de(mutexid);
+
+	if (f) {
+		unsigned int yo = FUTEX_POSEEDOR(zona_kernel->id);
+
+		/* libre: se coge sin entrar al nucleo */
+		if (__sync_bool_compare_and_swap(&f->palabra, 0, yo)) {
+			f->profundidad = 1;
+			f->inicio = *zona_kernel->ticks;
+			__sync_fetch_and_add(&f->estad->adquisiciones, 1);
+			subir_maximo(&f->estad->profundidad_max, 1);
+			return 0;
+		}
+		/* ya es mio y recursivo: solo sube la profundidad */
+		if ((f->palabra & ~FUTEX_ESPERANDO) == yo && f->tipo == RECURSIVO) {
+			subir_maximo(&f->estad->profundidad_max, ++f->profundidad);
+			return 0;
+		}
+	}
+	/* contienda o error: el nucleo bloquea o informa */
+	return llamsis(LOCK, 1, (long)mutexid);
+}
+int unlock(unsigned int mutexid){
+	palabra_futex *f = futex_de(mutexid);
+
+	if (f) {
+		unsigned int yo = FUTEX_POSEEDOR(zona_kernel->id);
+
+		if ((f->palabra & ~FUTEX_ESPERANDO) == yo && f->profundidad > 1) {
+			f->profundidad--;
+			return 0;
+		}
+		/* ultimo desbloqueo sin nadie esperando: se libera sin entrar
+		   al nucleo; si hay esperando falla y el nucleo lo cede. El
+		   tiempo de posesion se suma de forma atomica porque el
+		   siguiente poseedor puede soltarlo antes */
+		if (f->profundidad == 1) {
+			unsigned long poseido = *zona_kernel->ticks - f->inicio;
+
+			if (__sync_bool_compare_and_swap(&f->palabra, yo, 0)) {
+				__sync_fetch_and_add(&f->estad->posesion_total, poseido);
+				return 0;
+			}
+		}
+	}
+	return llamsis(UNLOCK, 1, (long)mutexid);
+}
+int cerrar_mutex(unsigned int mutexid){
+	return llamsis(CERRAR_MUTEX, 1, (long)mutexid);
+}
+int fijar_prioridad(unsigned int prioridad){
+	return llamsis(FIJAR_PRIORIDAD, 1, (long)prioridad);
+}
+int fijar_clase(unsigned int clase){
+	return llamsis(FIJAR_CLASE, 1, (long)clase);
+}
+int crear_rwlock(char *nombre, int preferencia){
+	return llamsis(CREAR_RWLOCK, 2, (long)nombre, (long)preferencia);
+}
+int abrir_rwlock(char *nombre){
+	return llamsis(ABRIR_RWLOCK, 1, (long)nombre);
+}
+int lock_lectura(unsigned int rwid){
+	return llamsis(LOCK_LECTURA, 1, (long)rwid);
+}
+int lock_escritura(unsigned int rwid){
+	return llamsis(LOCK_ESCRITURA, 1, (long)rwid);
+}
+int unlock_rw(unsigned int rwid){
+	return llamsis(UNLOCK_RW, 1, (long)rwid);
+}
+int cerrar_rwlock(unsigned int rwid){
+	return llamsis(CERRAR_RWLOCK, 1, (long)rwid);
+}
+int crear_semaforo(char *nombre, int valor){
+	return llamsis(CREAR_SEMAFORO, 2, (long)nombre, (long)valor);
+}
+int abrir_semaforo(char *nombre){
+	return llamsis(ABRIR_SEMAFORO, 1, (long)nombre);
+}
+int wait_sem(unsigned int semid){
+	return llamsis(WAIT_SEM, 1, (long)semid);
+}
+int signal_sem(unsigned int semid){
+	return llamsis(SIGNAL_SEM, 1, (long)semid);
+}
+int cerrar_semaforo(unsigned int semid){
+	return llamsis(CERRAR_SEMAFORO, 1, (long)semid);
+}
+int crear_condicion(char *nombre){
+	return llamsis(CREAR_CONDICION, 1, (long)nombre);
+}
+int abrir_condicion(char *nombre){
+	return llamsis(ABRIR_CONDICION, 1, (long)nombre);
+}
+int wait_cond(unsigned int condid, unsigned int mutexid){
+	return llamsis(WAIT_COND, 2, (long)condid, (long)mutexid);
+}
+int signal_cond(unsigned int condid){
+	return llamsis(SIGNAL_COND, 1, (long)condid);
+}
+int broadcast_cond(unsigned int condid){
+	return llamsis(BROADCAST_COND, 1, (long)condid);
+}
+int cerrar_condicion(unsigned int condid){
+	return llamsis(CERRAR_CONDICION, 1, (long)condid);
+}
+int estadisticas_mutex(unsigned int n){
+	return llamsis(ESTADISTICAS_MUTEX, 1, (long)n);
+}
+int enviar_anillo(anillo_llamsis *anillo){
+	return llamsis(ENVIAR_ANILLO, 1, (long)anillo);
+}
+int leer_caracter(){
+	return llamsis(LEER_CARACTER, 0);
+}
+int leer(char *buf, unsigned int n){
+	return llamsis(LEER, 2, (long)buf, (long)n);
+}
+int fijar_modo_terminal(int modo){
+	return llamsis(FIJAR_MODO_TERMINAL, 1, (long)modo);
+}
+int leer_log(char *buf, unsigned int tam){
+	return llamsis(LEER_LOG, 2, (long)buf, (long)tam);
+}
+int fijar_nivel_log(int nivel){
+	return llamsis(FIJAR_NIVEL_LOG, 1, (long)nivel);
+}
+int fijar_consola(int modo){
+	return llamsis(FIJAR_CONSOLA, 1, (long)modo);
+}
+
+/*
+ *
+ * Funciones de la pagina de datos del nucleo
+ *
+ */
+
+unsigned long obtener_ticks(){
+	return pagina_datos ? pagina_datos->ticks : 0;
+}
+
+/* Copia la pagina con el protocolo del seqlock: se repite si el nucleo la
+   estaba actualizando o la ha cambiado durante la copia */
+int leer_pagina_kernel(pagina_kernel *copia){
+	unsigned int sec;
+
+	if (pagina_datos == 0)
+		return -1;
+	do {
+		while ((sec = pagina_datos->secuencia) & 1)
+			;
+		__sync_synchronize();
+		*copia = *pagina_datos;
+		__sync_synchronize();
+	} while (pagina_datos->secuencia != sec);
+	return 0;
+}
+
+/*
+ *
+ * Funciones del anillo de llamadas: solo escriben las peticiones y leen
+ * las respuestas; el trabajo lo hace el nucleo en enviar_anillo
+ *
+ */
+
+void iniciar_anillo(anillo_llamsis *anillo){
+	anillo->ini_pet = anillo->fin_pet = 0;
+	anillo->ini_resp = anillo->fin_resp = 0;
+}
+
+static int encolar(anillo_llamsis *anillo, int llamada, long dato,
+		long arg1, long arg2){
+	peticion_llamsis *pet;
+
+	if (anillo->fin_pet - anillo->ini_pet >= TAM_ANILLO)
+		return -1;
+	pet = &anillo->pet[anillo->fin_pet % TAM_ANILLO];
+	pet->llamada = llamada;
+	pet->args[0] = arg1;
+	pet->args[1] = arg2;
+	pet->args[2] = 0;
+	pet->dato = dato;
+	anillo->fin_pet++;
+	return 0;
+}
+int encolar_escribir(anillo_llamsis *anillo, char *texto, unsigned int longi, long dato){
+	return encolar(anillo, ESCRIBIR, dato, (long)texto, (long)longi);
+}
+int encolar_obtener_id(anillo_llamsis *anillo, long dato){
+	return encolar(anillo, OBTENER_ID, dato, 0, 0);
+}
+int encolar_dormir(anillo_llamsis *anillo, unsigned int segundos, long dato){
+	return encolar(anillo, DORMIR, dato, (long)segundos, 0);
+}
+int encolar_lock(anillo_llamsis *anillo, unsigned int mutexid, long dato){
+	return encolar(anillo, LOCK, dato, (long)mutexid, 0);
+}
+int encolar_unlock(anillo_llamsis *anillo, unsigned int mutexid, long dato){
+	return encolar(anillo, UNLOCK, dato, (long)mutexid, 0);
+}
+int recoger_respuesta(anillo_llamsis *anillo, long *dato, int *resultado){
+	respuesta_llamsis *resp;
+
+	if (anillo->ini_resp == anillo->fin_resp)
+		return -1;
+	resp = &anillo->resp[anillo->ini_resp % TAM_ANILLO];
+	*dato = resp->dato;
+	*resultado = resp->resultado;
+	anillo->ini_resp++;
+	return 0;
+}
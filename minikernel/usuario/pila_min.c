@@ -0,0 +1,29 @@
+/*
+ * usuario/pila_min.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario que se crea con una pila de 4096 bytes y usa el
+ * doble en variables locales: solo funciona si el sistema la ha
+ * redondeado a la pila minima.
+ */
+
+#include "servicios.h"
+
+#define TAM_LOCAL 8192
+
+int main(){
+	volatile unsigned char local[TAM_LOCAL];
+	int i, suma=0;
+
+	for (i=0; i<TAM_LOCAL; i++)
+		local[i]=(unsigned char)i;
+	for (i=0; i<TAM_LOCAL; i++)
+		suma+=local[i];
+	printf("pila_min: %d bytes locales en una pila de 4096 redondeada (suma %d)\n",
+		TAM_LOCAL, suma);
+	return 0;
+}
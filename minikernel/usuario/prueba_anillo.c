@@ -0,0 +1,54 @@
+/*
+ * usuario/prueba_anillo.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario que prueba el anillo de llamadas: encola varias
+ * peticiones (una de ellas erronea y otra que bloquea) y las envia con una
+ * sola llamada al sistema. Despues llena el anillo para comprobar que no
+ * admite mas peticiones que entradas.
+ */
+
+#include "servicios.h"
+
+static anillo_llamsis anillo;
+
+int main(){
+	int desc, i, resultado, n;
+	long dato;
+	char msj[]="prueba_anillo: escrito desde el anillo\n";
+
+	printf("prueba_anillo: comienza\n");
+
+	if ((desc=crear_mutex("anillo", NO_RECURSIVO))<0)
+		printf("error creando anillo. NO DEBE APARECER\n");
+
+	iniciar_anillo(&anillo);
+	encolar_obtener_id(&anillo, 1);
+	encolar_lock(&anillo, desc, 2);
+	encolar_escribir(&anillo, msj, sizeof(msj)-1, 3);
+	encolar_unlock(&anillo, desc, 4);
+	encolar_dormir(&anillo, 1, 5);
+	encolar_unlock(&anillo, desc+1, 6);	/* descriptor no valido: -1 */
+
+	n=enviar_anillo(&anillo);
+	printf("prueba_anillo: %d peticiones en una llamada (DEBEN SER 6)\n", n);
+
+	while (recoger_respuesta(&anillo, &dato, &resultado)==0)
+		printf("prueba_anillo: peticion %ld -> %d\n", dato, resultado);
+
+	/* el anillo no admite mas de TAM_ANILLO peticiones pendientes */
+	for (i=0; encolar_obtener_id(&anillo, i)==0; i++)
+		;
+	printf("prueba_anillo: %d peticiones encoladas (DEBEN SER %d)\n", i, TAM_ANILLO);
+	n=enviar_anillo(&anillo);
+	for (i=0; recoger_respuesta(&anillo, &dato, &resultado)==0; i++)
+		;
+	printf("prueba_anillo: %d enviadas y %d respuestas\n", n, i);
+
+	printf("prueba_anillo: termina\n");
+	return 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * usuario/prueba_cond.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario que prueba los semaforos y las variables condicion.
+ * Primero seala la condicion hay mientras posee el mutex pc: consumidor
+ * pasa a esperar el mutex y solo continua cuando se suelta. Despues
+ * produce tres elementos con el semaforo elems, limitado por el
+ * semaforo huecos, de valor inicial 2.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int mut, cond, elementos, huecos, i;
+
+	printf("prueba_cond: comienza\n");
+
+	if ((mut=crear_mutex("pc", RECURSIVO))<0)
+		printf("error creando pc. NO DEBE APARECER\n");
+	if ((cond=crear_condicion("hay"))<0)
+		printf("error creando hay. NO DEBE APARECER\n");
+	if ((elementos=crear_semaforo("elems", 0))<0)
+		printf("error creando elems. NO DEBE APARECER\n");
+	if ((huecos=crear_semaforo("huecos", 2))<0)
+		printf("error creando huecos. NO DEBE APARECER\n");
+
+	if (wait_cond(cond, mut)==0)
+		printf("wait_cond sin el mutex. NO DEBE APARECER\n");
+
+	if (crear_proceso("consumidor")<0)
+		printf("Error creando consumidor\n");
+
+	/* consumidor se bloquea en la condicion */
+	dormir(1);
+
+	lock(mut);
+	signal_cond(cond);
+	printf("prueba_cond: condicion sealada con el mutex. DEBE APARECER ANTES QUE consumidor\n");
+	unlock(mut);
+
+	for (i=1; i<=3; i++) {
+		wait_sem(huecos);
+		printf("prueba_cond: produce %d\n", i);
+		signal_sem(elementos);
+	}
+
+	/* contienda de los objetos usados hasta ahora */
+	estadisticas_mutex(0);
+
+	printf("prueba_cond: termina\n");
+	return 0;
+}
@@ -0,0 +1,42 @@
+/*
+ * usuario/prueba_consola.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la consola con escritura combinada: crea
+ * dos procesos que escriben sus lineas a trozos mientras se expulsan uno a
+ * otro (las lineas no deben mezclarse), comprueba que un texto sin salto
+ * se ve mientras el proceso duerme, sin que otro continue su linea, y el
+ * cambio a salida directa.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int i;
+
+	printf("prueba_consola: comienza\n");
+
+	for (i=1; i<=2; i++)
+		if (crear_proceso("trozos")<0)
+			printf("Error creando trozos\n");
+
+	/* el indicador debe verse antes de las lineas escritas mientras duerme,
+	   que empiezan en linea nueva */
+	printf("prueba_consola: indicador sin salto... ");
+	dormir(1);
+	printf("prueba_consola: despierta\n");
+
+	if (fijar_consola(5)!=-1)
+		printf("modo no valido aceptado. NO DEBE APARECER\n");
+	if (fijar_consola(CONSOLA_DIRECTA)!=CONSOLA_LINEAS)
+		printf("modo inicial distinto de lineas. NO DEBE APARECER\n");
+	printf("prueba_consola: ");
+	printf("salida directa\n");
+
+	printf("prueba_consola: termina\n");
+	return 0;
+}
@@ -0,0 +1,48 @@
+/*
+ * usuario/prueba_herencia.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la herencia de prioridad en los mutex.
+ * Con prioridad baja posee un mutex que espera herencia_alta, de prioridad
+ * alta, mientras varios yosoy de prioridad media compiten por la UCP. Al
+ * heredar la prioridad de herencia_alta debe poder soltar el mutex sin
+ * esperar a que terminen los yosoy.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int i, desc;
+
+	printf("prueba_herencia: comienza\n");
+
+	/* procesos de prioridad media */
+	fijar_prioridad(15);
+	for (i=1; i<=3; i++)
+		if (crear_proceso("yosoy")<0)
+			printf("Error creando yosoy\n");
+
+	fijar_prioridad(5);
+	if ((desc=crear_mutex("inv", NO_RECURSIVO))<0)
+		printf("error creando inv. NO DEBE APARECER\n");
+	if (lock(desc)<0)
+		printf("error en lock de inv. NO DEBE APARECER\n");
+
+	/* proceso de prioridad alta que se bloqueara en el mutex */
+	if (crear_proceso("herencia_alta")<0)
+		printf("Error creando herencia_alta\n");
+
+	/* pasa a prioridad baja: ejecuta herencia_alta, que se bloquea */
+	fijar_prioridad(20);
+
+	printf("prueba_herencia: con la prioridad heredada suelta el mutex. DEBE APARECER ANTES DE QUE TERMINEN LOS yosoy\n");
+	if (unlock(desc)<0)
+		printf("error en unlock de inv. NO DEBE APARECER\n");
+
+	printf("prueba_herencia: termina\n");
+	return 0; 
+}
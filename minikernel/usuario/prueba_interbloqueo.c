@@ -0,0 +1,45 @@
+/*
+ * usuario/prueba_interbloqueo.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la deteccion de interbloqueos. Posee el
+ * mutex a mientras bloqueador, que posee b, espera por a. Al pedir b
+ * cerraria el ciclo, asi que el lock debe fallar con ERR_INTERBLOQUEO;
+ * tras soltar a, bloqueador puede terminar.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int a, b;
+
+	printf("prueba_interbloqueo: comienza\n");
+
+	if ((a=crear_mutex("a", NO_RECURSIVO))<0)
+		printf("error creando a. NO DEBE APARECER\n");
+	if ((b=crear_mutex("b", NO_RECURSIVO))<0)
+		printf("error creando b. NO DEBE APARECER\n");
+	if (lock(a)<0)
+		printf("error en lock de a. NO DEBE APARECER\n");
+
+	if (crear_proceso("bloqueador")<0)
+		printf("Error creando bloqueador\n");
+
+	/* bloqueador coge b y espera por a */
+	dormir(1);
+
+	if (lock(b)==ERR_INTERBLOQUEO)
+		printf("prueba_interbloqueo: lock de b rechazado por interbloqueo\n");
+	else
+		printf("lock de b sin detectar el ciclo. NO DEBE APARECER\n");
+
+	if (unlock(a)<0)
+		printf("error en unlock de a. NO DEBE APARECER\n");
+
+	printf("prueba_interbloqueo: termina\n");
+	return 0;
+}
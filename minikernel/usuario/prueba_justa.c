@@ -0,0 +1,42 @@
+/*
+ * usuario/prueba_justa.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la CLASE_JUSTA. Crea varios procesos justo
+ * que calculan sin bloquearse y deben repartirse la UCP por igual. Pasa
+ * tambien a CLASE_JUSTA y duerme 1 segundo: al despertar, el credito por
+ * haber dormido le hace ejecutar de inmediato, aunque los justo sigan.
+ */
+
+#include "servicios.h"
+
+int main(){
+	unsigned long antes, despues;
+	int i;
+
+	printf("prueba_justa: comienza\n");
+
+	for (i=1; i<=3; i++)
+		if (crear_proceso("justo")<0)
+			printf("Error creando justo\n");
+
+	if (fijar_clase(5)!=-1)
+		printf("clase no valida aceptada. NO DEBE APARECER\n");
+	if (fijar_clase(CLASE_JUSTA)!=CLASE_PRIORIDAD)
+		printf("error fijando clase. NO DEBE APARECER\n");
+
+	antes=obtener_ticks();
+	dormir(1);
+	despues=obtener_ticks();
+	printf("prueba_justa: despierta tras %lu ticks (DEBEN SER 100 O POCOS MAS)\n",
+		despues-antes);
+	printf("prueba_justa: DEBE APARECER ANTES DE QUE TERMINEN LOS justo\n");
+	printf("prueba_justa: los justo DEBEN DAR UN NUMERO PARECIDO DE VUELTAS\n");
+
+	printf("prueba_justa: termina\n");
+	return 0;
+}
@@ -0,0 +1,45 @@
+/*
+ * usuario/prueba_leer.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la lectura del terminal por bloques: lee
+ * con una llamada lo que haya llegado en modo crudo y despues, en modo
+ * canonico, lineas completas (con borrado) hasta un fin de fichero
+ * (control-D).
+ */
+
+#include "servicios.h"
+
+int main(){
+	char buf[32];
+	int n, llamadas=0;
+
+	printf("prueba_leer: comienza\n");
+
+	printf("prueba_leer: pulsa caracteres en modo crudo\n");
+	dormir(2);
+	n=leer(buf, sizeof(buf)-1);
+	buf[n]='\0';
+	printf("prueba_leer: %d caracteres en una llamada: %s\n", n, buf);
+
+	if (fijar_modo_terminal(TERM_CANONICO)!=TERM_CRUDO)
+		printf("modo inicial distinto del crudo. NO DEBE APARECER\n");
+	if (fijar_modo_terminal(5)!=-1)
+		printf("modo no valido aceptado. NO DEBE APARECER\n");
+
+	printf("prueba_leer: escribe lineas y termina con control-D\n");
+	while ((n=leer(buf, sizeof(buf)-1))>0) {
+		llamadas++;
+		buf[n]='\0';
+		printf("prueba_leer: linea de %d caracteres: %s", n, buf);
+	}
+	printf("prueba_leer: fin de fichero tras %d llamadas\n", llamadas);
+
+	fijar_modo_terminal(TERM_CRUDO);
+	printf("prueba_leer: termina\n");
+	return 0;
+}
@@ -0,0 +1,45 @@
+/*
+ * usuario/prueba_log.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario que prueba el registro del nucleo: sube el umbral a
+ * LOG_DEPURACION mientras usa un mutex y duerme, lo restaura y recupera
+ * despues los mensajes con leer_log.
+ */
+
+#include "servicios.h"
+
+static char buf[8192];
+
+int main(){
+	int desc, anterior, lon;
+
+	printf("prueba_log: comienza\n");
+
+	if (fijar_nivel_log(7)!=-1)
+		printf("nivel no valido aceptado. NO DEBE APARECER\n");
+
+	anterior=fijar_nivel_log(LOG_DEPURACION);
+	printf("prueba_log: umbral anterior %d (DEBE SER %d)\n", anterior, LOG_INFO);
+
+	if ((desc=crear_mutex("log", NO_RECURSIVO))<0)
+		printf("error creando log. NO DEBE APARECER\n");
+	lock(desc);
+	unlock(desc);
+	cerrar_mutex(desc);
+	dormir(1);
+
+	fijar_nivel_log(anterior);
+	dormir(1);	/* sin mensajes por tick */
+
+	lon=leer_log(buf, sizeof(buf));
+	printf("prueba_log: %d bytes en el registro:\n", lon);
+	escribir(buf, lon);
+
+	printf("prueba_log: termina\n");
+	return 0;
+}
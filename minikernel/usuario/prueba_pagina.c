@@ -0,0 +1,44 @@
+/*
+ * usuario/prueba_pagina.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la pagina de datos del nucleo: espera
+ * activamente un segundo consultando el reloj sin llamadas al sistema y
+ * comprueba que la pagina refleja su id, su prioridad y los procesos vivos.
+ */
+
+#include "servicios.h"
+
+int main(){
+	pagina_kernel pag;
+	unsigned long inicio, lecturas=0;
+
+	printf("prueba_pagina: comienza\n");
+
+	if (leer_pagina_kernel(&pag)<0) {
+		printf("pagina no publicada. NO DEBE APARECER\n");
+		return 1;
+	}
+	printf("prueba_pagina: id %d prioridad %d clase %d procesos %d\n",
+		pag.id, pag.prioridad, pag.clase, pag.procs_vivos);
+
+	fijar_prioridad(5);
+	leer_pagina_kernel(&pag);
+	printf("prueba_pagina: prioridad %d (DEBE SER 5)\n", pag.prioridad);
+
+	/* espera activa de un segundo: sin llamadas, solo lecturas */
+	inicio=obtener_ticks();
+	while (obtener_ticks()-inicio < 100)	/* TICK del nucleo */
+		lecturas++;
+	printf("prueba_pagina: un segundo tras %lu lecturas del reloj\n", lecturas);
+
+	if (obtener_id_pr()!=pag.id)
+		printf("id distinto en la pagina. NO DEBE APARECER\n");
+
+	printf("prueba_pagina: termina\n");
+	return 0;
+}
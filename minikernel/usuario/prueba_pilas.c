@@ -0,0 +1,41 @@
+/*
+ * usuario/prueba_pilas.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la cache de pilas y la eleccion del
+ * tamao de pila. Crea por tandas procesos con la pila por defecto, que
+ * deben reutilizar las pilas de los anteriores, y otros con pilas de
+ * distintos tamaos; una pila pequea se redondea a la minima. Una pila
+ * demasiado grande debe ser rechazada. Al terminar el sistema se muestran
+ * los aciertos y fallos de la cache.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int i, tanda;
+
+	printf("prueba_pilas: comienza\n");
+
+	for (tanda=1; tanda<=3; tanda++) {
+		for (i=0; i<4; i++)
+			if (crear_proceso("simplon")<0)
+				printf("Error creando simplon\n");
+		dormir(1);
+	}
+
+	if (crear_proceso_pila("simplon", 100000)<0)
+		printf("Error creando simplon con pila de 100000\n");
+	/* se redondea a la pila minima: pila_min usa mas de lo pedido */
+	if (crear_proceso_pila("pila_min", 4096)<0)
+		printf("Error creando pila_min con pila de 4096\n");
+	if (crear_proceso_pila("simplon", 1<<30)==0)
+		printf("prueba_pilas: pila de 1GB. NO DEBE APARECER\n");
+
+	printf("prueba_pilas: termina\n");
+	return 0; 
+}
@@ -0,0 +1,34 @@
+/*
+ * usuario/prueba_prio.c
+ *
+ *  Minikernel. Versin 1.0
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de la expulsion por prioridad.
+ * Crea varios procesos yosoy que compiten por la UCP y, con la prioridad
+ * maxima, duerme 1 segundo. Al despertar debe ejecutar de inmediato, sin
+ * esperar a que los yosoy agoten su rodaja ni terminen.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int i;
+
+	printf("prueba_prio: comienza\n");
+
+	for (i=1; i<=5; i++)
+		if (crear_proceso("yosoy")<0)
+			printf("Error creando yosoy\n");
+
+	if (fijar_prioridad(0)<0)
+		printf("error fijando prioridad. NO DEBE APARECER\n");
+
+	dormir(1);
+	printf("prueba_prio: despierta y expulsa a yosoy. DEBE APARECER ANTES DE QUE TERMINEN\n");
+
+	printf("prueba_prio: termina\n");
+	return 0; 
+}
@@ -0,0 +1,39 @@
+/*
+ * usuario/prueba_procs.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la tabla de procesos dinamica. Crea mas
+ * procesos que la dimension inicial de la tabla, que debe ampliarse, y
+ * cuando estos han terminado crea otros, que no deben repetir ninguno de
+ * los identificadores anteriores.
+ */
+
+#include "servicios.h"
+
+#define NUM_PROCS 25
+
+int main(){
+	int i, creados=0;
+
+	printf("prueba_procs (%d): comienza\n", obtener_id_pr());
+
+	for (i=0; i<NUM_PROCS; i++)
+		if (crear_proceso("simplon")==0)
+			creados++;
+	printf("prueba_procs: creados %d de %d. DEBEN SER TODOS\n",
+		creados, NUM_PROCS);
+
+	/* espera a que terminen y queden libres sus entradas */
+	dormir(2);
+
+	for (i=0; i<3; i++)
+		if (crear_proceso("yosoy")<0)
+			printf("Error creando yosoy\n");
+
+	printf("prueba_procs: termina\n");
+	return 0; 
+}
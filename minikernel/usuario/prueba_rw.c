@@ -0,0 +1,52 @@
+/*
+ * usuario/prueba_rw.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario que prueba el rwlock con preferencia de escritores.
+ * Mientras lee, entra otro lector sin esperar; despues llega un escritor,
+ * que espera, y un segundo lector, que ya no puede adelantarle. El
+ * escritor debe escribir antes de que lea el segundo lector.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int desc;
+
+	printf("prueba_rw: comienza\n");
+
+	if ((desc=crear_rwlock("rw", RW_PREF_ESCRITORES))<0)
+		printf("error creando rw. NO DEBE APARECER\n");
+
+	if (lock(desc)==0)
+		printf("lock de mutex sobre un rwlock. NO DEBE APARECER\n");
+
+	if (lock_lectura(desc)<0)
+		printf("error en lock_lectura de rw. NO DEBE APARECER\n");
+
+	/* primer lector: entra aunque prueba_rw este leyendo */
+	if (crear_proceso("lector_rw")<0)
+		printf("Error creando lector_rw\n");
+	dormir(1);
+
+	/* escritor: espera a que salgan los lectores */
+	if (crear_proceso("escritor_rw")<0)
+		printf("Error creando escritor_rw\n");
+	dormir(1);
+
+	/* segundo lector: espera detras del escritor */
+	if (crear_proceso("lector_rw")<0)
+		printf("Error creando lector_rw\n");
+	dormir(1);
+
+	printf("prueba_rw: deja de leer\n");
+	if (unlock_rw(desc)<0)
+		printf("error en unlock_rw de rw. NO DEBE APARECER\n");
+
+	printf("prueba_rw: termina\n");
+	return 0;
+}
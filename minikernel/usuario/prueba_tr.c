@@ -0,0 +1,62 @@
+/*
+ * usuario/prueba_tr.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de la clase de tiempo real.
+ * Crea varios procesos yosoy y pasa a CLASE_TR con un periodo de 50 ticks
+ * y un presupuesto de 5. Comprueba el control de admision y que, aunque
+ * los yosoy compitan por la UCP, ejecuta una vez en cada periodo. Por
+ * ultimo agota su presupuesto y debe quedar estrangulado.
+ */
+
+#include "servicios.h"
+
+#define PERIODO 50
+#define PRESUPUESTO 5
+#define NUM_PERIODOS 5
+
+int main(){
+	int i;
+	volatile int j;
+
+	printf("prueba_tr: comienza\n");
+
+	for (i=1; i<=3; i++)
+		if (crear_proceso("yosoy")<0)
+			printf("Error creando yosoy\n");
+
+	if (fijar_tiempo_real(PERIODO, PERIODO+1, 0)==0)
+		printf("prueba_tr: presupuesto mayor que plazo. NO DEBE APARECER\n");
+
+	if (fijar_tiempo_real(PERIODO, PRESUPUESTO, 0)<0)
+		printf("prueba_tr: error pasando a tiempo real. NO DEBE APARECER\n");
+
+	if (fijar_tiempo_real(PERIODO, PERIODO-1, 0)==0)
+		printf("prueba_tr: excede la utilizacion maxima. NO DEBE APARECER\n");
+
+	/* presupuesto*1000 no cabe en 32 bits: no debe colarse como pequeo */
+	if (fijar_tiempo_real(5000000, 5000000, 0)==0)
+		printf("prueba_tr: reserva enorme admitida. NO DEBE APARECER\n");
+
+	if (fijar_clase(CLASE_TR)==0)
+		printf("prueba_tr: CLASE_TR con fijar_clase. NO DEBE APARECER\n");
+
+	for (i=1; i<=NUM_PERIODOS; i++) {
+		printf("prueba_tr: periodo %d\n", i);
+		esperar_periodo();
+	}
+
+	printf("prueba_tr: agota su presupuesto. DEBE QUEDAR ESTRANGULADO\n");
+	for (i=0; i<20; i++) {
+		for (j=0; j<5000000; j++)
+			;
+		printf("prueba_tr: i %d\n", i);
+	}
+
+	printf("prueba_tr: termina\n");
+	return 0; 
+}
@@ -0,0 +1,38 @@
+/*
+ * usuario/trozos.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ */
+
+/*
+ * Programa de usuario que escribe cada linea en varias llamadas, con
+ * calculo entre ellas para que lo expulsen a mitad de linea.
+ */
+
+#include "servicios.h"
+
+#define TOT_ITER 8
+#define ESPERA 30000000
+
+static void calcular(){
+	volatile int i;
+
+	for (i=0; i<ESPERA; i++)
+		;
+}
+
+int main(){
+	int i, id;
+
+	id=obtener_id_pr();
+	for (i=0; i<TOT_ITER; i++) {
+		printf("trozos (%d): ", id);
+		calcular();
+		printf("linea %d ", i);
+		calcular();
+		printf("completa\n");
+	}
+	printf("trozos (%d): termina\n", id);
+	return 0;
+}